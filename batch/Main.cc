@@ -0,0 +1,302 @@
+/*****************************************************************************************[Main.cc]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../utils/System.h"
+#include "../utils/ParseUtils.h"
+#include "../utils/Options.h"
+#include "../core/Dimacs.h"
+#include "../core/SimdScan.h"
+#include "../simp/ParallelSolver.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Batch solving:
+//
+// Every worker thread takes the next instance from the job list (or the spool directory), solves
+// it with a fresh portfolio and appends one JSON object per job to the result stream. The process,
+// its worker threads and their coroutine stack pools live for the whole batch; no per-job
+// directories or clause logs are created.
+
+typedef std::chrono::steady_clock Clock;
+
+static std::atomic<bool> stop(false);
+
+static void SIGINT_stop(int signum) { stop = true; }
+
+struct Job {
+    int         id;
+    std::string file;
+    std::string name;       // The spool entry it was claimed as (empty for job lists).
+};
+
+// The file of a job once its result is written ('<name>.done' for spool entries, see 'JobQueue'):
+static std::string doneFile(const Job& j)
+{
+    return j.name.empty() ? j.file : j.file.substr(0, j.file.size() - strlen(".taken")) + ".done";
+}
+
+struct Budget {
+    double   time;    // Wall-clock seconds per job.
+    uint64_t mem;     // Bytes of clause memory per job.
+};
+
+class JobQueue {
+    std::mutex          mtx;
+    std::vector<Job>    jobs;
+    int                 next_job;
+    int                 next_id;
+    std::string         spool;
+    std::set<std::string> taken;    // Claimed spool entries whose results are not written yet.
+
+    static bool isInstance(const std::string& name) {
+        size_t n = name.size();
+        return (n > 4 && name.compare(n-4, 4, ".cnf") == 0)
+            || (n > 7 && name.compare(n-7, 7, ".cnf.gz") == 0); }
+
+    // Claims the new instances of the spool directory by renaming them to '<name>.taken'. Several
+    // batch processes may share one spool directory; 'rename()' lets exactly one of them win. Once
+    // its result is written, an instance is renamed again to '<name>.done' (see 'done()').
+    void scanSpool() {
+        DIR* dir = opendir(spool.c_str());
+        if (dir == NULL) return;
+        while (struct dirent* e = readdir(dir)){
+            std::string name = e->d_name;
+            if (!isInstance(name) || taken.count(name)) continue;
+            std::string from = spool + "/" + name;
+            std::string to   = from + ".taken";
+            if (rename(from.c_str(), to.c_str()) == 0){
+                Job j = { next_id++, to, name };
+                jobs.push_back(j);
+                taken.insert(name); }
+        }
+        closedir(dir); }
+
+public:
+    JobQueue() : next_job(0), next_id(0) {}
+
+    void add(const std::string& file) { Job j = { next_id++, file, "" }; jobs.push_back(j); }
+    void setSpool(const std::string& dir) { spool = dir; }
+
+    // Returns FALSE when there is no job left. In spool mode, waits for new instances until the
+    // file 'STOP' appears in the spool directory or the batch is interrupted.
+    bool pop(Job& j) {
+        for (;;){
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (next_job == (int)jobs.size() && !spool.empty())
+                    scanSpool();
+                if (next_job < (int)jobs.size()){
+                    j = jobs[next_job++];
+                    return true; }
+            }
+            if (spool.empty() || stop || access((spool + "/STOP").c_str(), F_OK) == 0)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        } }
+
+    // Called once the result of 'j' is written: the spool entry is moved out of the way of the ones
+    // still being solved, and an instance of the same name may be claimed again.
+    void done(const Job& j) {
+        if (j.name.empty()) return;
+        std::string to = doneFile(j);
+        if (rename(j.file.c_str(), to.c_str()) != 0)
+            fprintf(stderr, "WARNING! Could not rename %s to %s (%s)\n", j.file.c_str(), to.c_str(), strerror(errno));
+        std::lock_guard<std::mutex> lock(mtx);
+        taken.erase(j.name); }
+};
+
+class Results {
+    std::mutex mtx;
+    FILE*      out;
+public:
+    explicit Results(FILE* f) : out(f) {}
+    void write(const std::string& line) {
+        std::lock_guard<std::mutex> lock(mtx);
+        fputs(line.c_str(), out);
+        fputc('\n', out);
+        fflush(out); }
+};
+
+static std::string jsonString(const std::string& s)
+{
+    std::string r = "\"";
+    for (size_t i = 0; i < s.size(); i++){
+        unsigned char c = s[i];
+        if      (c == '"' || c == '\\') { r += '\\'; r += c; }
+        else if (c < 0x20)              { char buf[8]; snprintf(buf, sizeof(buf), "\\u%04x", c); r += buf; }
+        else                            r += c;
+    }
+    return r + "\"";
+}
+
+static double seconds(Clock::time_point from) { return std::chrono::duration<double>(Clock::now() - from).count(); }
+
+static std::string runJob(const Job& job, int num_solvers, const StackAllocator& salloc, bool pre, const Budget& budget, bool with_model)
+{
+    Clock::time_point start = Clock::now();
+    char buf[256];
+    std::string r = "{\"job\":" + std::to_string(job.id) + ",\"file\":" + jsonString(doneFile(job));
+
+    gzFile in = gzopen(job.file.c_str(), "rb");
+    if (in == NULL)
+        return r + ",\"result\":\"ERROR\",\"reason\":\"open\"}";
+
+    const char* reason = NULL;
+    lbool       ret    = l_Undef;
+    try {
+        ParallelSolver S(num_solvers, salloc);
+        S.setVerbosity(0);
+        S.setStopOnFirst(true);
+        if (!pre) S.eliminate(true);
+        parse_DIMACS(in, S);
+        gzclose(in); in = NULL;
+        double parse_time = seconds(start);
+
+        S.setProgressCallback([&](ParallelSolver& P){
+            if      (stop)                                  reason = "interrupted";
+            else if (seconds(start) > budget.time)          reason = "time";
+            else if (P.clauseBytes() > budget.mem)          reason = "memory";
+            else return;
+            P.interrupt();
+        }, 64);
+
+        S.eliminate(true);
+        if (S.okay())
+            ret = S.solveLimited();
+        else
+            ret = l_False;
+
+        snprintf(buf, sizeof(buf), ",\"vars\":%d,\"clauses\":%d,\"parse_time\":%.3f,\"time\":%.3f,\"winner\":%d",
+                 S.nVars(), S.nClauses(), parse_time, seconds(start), S.winner());
+        r += buf;
+        if (S.winner() != -1){
+            SimpSolver& w = S.instance(S.winner());
+            snprintf(buf, sizeof(buf), ",\"conflicts\":%" PRIu64 ",\"iterations\":%lld", w.conflicts, w.iterations);
+            r += buf; }
+
+        r += ret == l_True ? ",\"result\":\"SAT\"" : ret == l_False ? ",\"result\":\"UNSAT\"" : ",\"result\":\"INDET\"";
+        if (ret == l_Undef && reason != NULL)
+            r += std::string(",\"reason\":\"") + reason + "\"";
+
+        if (ret == l_True && with_model){
+            r += ",\"model\":[";
+            for (int i = 0; i < S.nVars(); i++)
+                if (S.model[i] != l_Undef){
+                    snprintf(buf, sizeof(buf), "%s%s%d", i == 0 ? "" : ",", S.model[i] == l_True ? "" : "-", i+1);
+                    r += buf; }
+            r += "]"; }
+    } catch (OutOfMemoryException&){
+        if (in != NULL) gzclose(in);
+        snprintf(buf, sizeof(buf), ",\"time\":%.3f", seconds(start));
+        return r + buf + ",\"result\":\"INDET\",\"reason\":\"memory\"}";
+    }
+
+    return r + "}";
+}
+
+//=================================================================================================
+// Main:
+
+int main(int argc, char** argv)
+{
+    setUsageHelp("USAGE: %s [options] <job-list>\n\n  where <job-list> names one plain or gzipped DIMACS file per line ('-' for standard input).\n"
+                 "  With '-spool', instances are instead taken from a directory as they appear.\n");
+
+#if defined(__linux__)
+    fpu_control_t oldcw, newcw;
+    _FPU_GETCW(oldcw); newcw = (oldcw & ~_FPU_EXTENDED) | _FPU_DOUBLE; _FPU_SETCW(newcw);
+#endif
+    // Extra options:
+    //
+    IntOption    threads    ("BATCH", "threads", "Number of worker threads.\n", 1, IntRange(1, INT32_MAX));
+    IntOption    num_solvers("BATCH", "solvers", "Number of interleaved solver instances per job (1 = a single solver).\n", 1, IntRange(1, 4));
+    BoolOption   pre        ("BATCH", "pre",     "Completely turn on/off any preprocessing.", true);
+    IntOption    time_lim   ("BATCH", "time-lim","Limit on wall-clock time per job in seconds.\n", INT32_MAX, IntRange(0, INT32_MAX));
+    IntOption    mem_lim    ("BATCH", "mem-lim", "Limit on clause memory per job in megabytes.\n", INT32_MAX, IntRange(0, INT32_MAX));
+    StringOption spool      ("BATCH", "spool",   "Watch this directory for new instances instead of reading a job list.");
+    StringOption out        ("BATCH", "out",     "Write the JSON Lines results to this file (default: standard output).");
+    BoolOption   with_model ("BATCH", "model",   "Include the model of satisfiable instances in the results.", false);
+
+    parseOptions(argc, argv, true);
+    selectSimdScan();
+
+    JobQueue jobs;
+    if (spool)
+        jobs.setSpool((const char*)spool);
+    else{
+        if (argc < 2)
+            printf("ERROR! No job list given. Use '--help' for help.\n"), exit(1);
+        FILE* list = strcmp(argv[1], "-") == 0 ? stdin : fopen(argv[1], "r");
+        if (list == NULL)
+            printf("ERROR! Could not open file: %s\n", argv[1]), exit(1);
+        char line[4096];
+        while (fgets(line, sizeof(line), list) != NULL){
+            size_t n = strlen(line);
+            while (n > 0 && (line[n-1] == '\n' || line[n-1] == '\r' || line[n-1] == ' ')) line[--n] = '\0';
+            if (n > 0 && line[0] != '#') jobs.add(line);
+        }
+        if (list != stdin) fclose(list);
+    }
+
+    FILE* res = out ? fopen(out, "w") : stdout;
+    if (res == NULL)
+        printf("ERROR! Could not open file: %s\n", (const char*)out), exit(1);
+    Results results(res);
+
+    Budget budget;
+    budget.time = time_lim == INT32_MAX ? 1e300 : (double)time_lim;
+    budget.mem  = mem_lim  == INT32_MAX ? UINT64_MAX : (uint64_t)mem_lim * 1024*1024;
+
+    // Interrupting the batch stops the running jobs (reported as "interrupted") and takes no new ones:
+    signal(SIGINT, SIGINT_stop);
+    signal(SIGTERM,SIGINT_stop);
+
+    int nthreads = threads;
+    int nsolvers = num_solvers;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < nthreads; t++)
+        workers.emplace_back([&](){
+            // One stack pool per worker, reused by all of its jobs:
+            StackAllocator salloc(stack_Pooled);
+            Job job;
+            while (!stop && jobs.pop(job)){
+                results.write(runJob(job, nsolvers, salloc, pre, budget, with_model));
+                jobs.done(job); }
+        });
+    for (size_t t = 0; t < workers.size(); t++)
+        workers[t].join();
+
+    if (res != stdout) fclose(res);
+    return stop ? 1 : 0;
+}
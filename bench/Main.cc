@@ -0,0 +1,170 @@
+/*****************************************************************************************[Main.cc]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include "../utils/Options.h"
+#include "../mtl/Vec.h"
+#include "../core/Decay.h"
+#include "../core/SimdScan.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Microbenchmarks of the solver's inner loops:
+//
+// Each one replays synthetic inputs from cache and prints the time per call of the solver's code
+// next to the code it replaced, so that the numbers quoted for these changes can be reproduced.
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds(Clock::time_point from) { return std::chrono::duration<double>(Clock::now() - from).count(); }
+
+// xorshift64*, as in 'Walker':
+static uint64_t seed = 91648253;
+static double drand() {
+    seed ^= seed >> 12; seed ^= seed << 25; seed ^= seed >> 27;
+    return ((seed * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0); }
+
+static volatile double sink;    // (keeps the results alive)
+
+//-------------------------------------------------------------------------------------------------
+// Anti-exploration decay: 'pow(0.95, age)' against 'decayFactor(age)', for ages drawn from a
+// geometric distribution (the conflicts a variable spends unassigned):
+
+static void benchDecay(int reps, double mean)
+{
+    vec<uint64_t> ages;
+    for (int i = 0; i < 65536; i++)
+        ages.push((uint64_t)(log(1 - drand()) / log(1 - 1 / mean)));
+
+    double max_err = 0;
+    for (int i = 0; i < ages.size(); i++){
+        double p = pow(0.95, (double)ages[i]);
+        if (p > 0 && fabs(decayFactor(ages[i]) - p) / p > max_err)
+            max_err = fabs(decayFactor(ages[i]) - p) / p; }
+
+    double            sum   = 0;
+    Clock::time_point start = Clock::now();
+    for (int r = 0; r < reps; r++)
+        for (int i = 0; i < ages.size(); i++)
+            sum += pow(0.95, (double)ages[i]);
+    double t_pow = seconds(start);
+
+    start = Clock::now();
+    for (int r = 0; r < reps; r++)
+        for (int i = 0; i < ages.size(); i++)
+            sum += decayFactor(ages[i]);
+    double t_table = seconds(start);
+    sink = sum;
+
+    double calls = (double)reps * ages.size();
+    printf("decay (geometric ages, mean %g):\n", mean);
+    printf("  pow(0.95, age)    %8.2f ns\n", t_pow   / calls * 1e9);
+    printf("  decayFactor(age)  %8.2f ns   (max rel. error %.1e)\n", t_table / calls * 1e9, max_err);
+}
+
+//-------------------------------------------------------------------------------------------------
+// Clause scans: the plain loop 'propagate()' used to search for a replacement watch, against
+// 'scanNotFalse()' with the scalar and the AVX2 block scanners. Each clause has 'len' literals that
+// are false up to its 'stop'-th one (all of them, if 'stop' is 'len'), which is true; 'stop' is
+// drawn uniformly from 0..len if given as -1.
+
+static int scanLoop(const Lit* lits, int n, const lbool* assigns)
+{
+    for (int i = 0; i < n; i++)
+        if ((assigns[var(lits[i])] ^ sign(lits[i])) != l_False)
+            return i;
+    return n;
+}
+
+static void benchScan(int reps, int len, int stop, int nvars)
+{
+    enum { nclauses = 4096 };
+    vec<lbool> assigns;
+    for (int v = 0; v < nvars + 3; v++)       // (readable beyond the last variable, see 'SimdScan.h')
+        assigns.push(lbool(drand() < 0.5));
+
+    vec<Lit> lits;
+    for (int c = 0; c < nclauses; c++){
+        int s = stop >= 0 ? (stop < len ? stop : len) : (int)(drand() * (len + 1));
+        for (int k = 0; k < len; k++){
+            Var v = (Var)(drand() * nvars);
+            // Literal 'k' is false before 's', and true at 's':
+            lits.push(mkLit(v, (assigns[v] == l_True) == (k != s))); } }
+
+    int    (*scans[])(const Lit*, int, const lbool*) = { scanLoop, scanNotFalse, scanNotFalse };
+    const char* names[] = { "plain loop", "scanNotFalse (scalar)", "scanNotFalse (avx2)" };
+    uint64_t    inspected = 0;
+    for (int c = 0; c < nclauses; c++)
+        inspected += scanLoop(&lits[c * len], len, &assigns[0]) + 1;
+    for (int c = 0; c < nclauses; c++)
+        if (scanNotFalse(&lits[c * len], len, &assigns[0]) != scanLoop(&lits[c * len], len, &assigns[0]))
+            printf("ERROR! The scanners disagree.\n"), exit(1);
+
+    printf("scan (%d literals, %.1f inspected on average, %d variables):\n", len, (double)inspected / nclauses, nvars);
+    for (int i = 0; i < 3; i++){
+        if (i == 2 && !simdScanAvailable()){
+            printf("  %-22s        (no AVX2)\n", names[i]);
+            continue; }
+        setSimdScan(i == 2);
+        uint64_t sum = 0;
+        for (int c = 0; c < nclauses; c++)      // (warm-up)
+            sum += scans[i](&lits[c * len], len, &assigns[0]);
+        double best = HUGE_VAL;                 // (the fastest pass, as the machine may be busy)
+        for (int r = 0; r < reps; r++){
+            Clock::time_point start = Clock::now();
+            for (int c = 0; c < nclauses; c++)
+                sum += scans[i](&lits[c * len], len, &assigns[0]);
+            best = std::min(best, seconds(start)); }
+        sink = (double)sum;
+        printf("  %-22s %8.2f ns\n", names[i], best / nclauses * 1e9);
+    }
+    setSimdScan(true);
+}
+
+//=================================================================================================
+// Main:
+
+int main(int argc, char** argv)
+{
+    setUsageHelp("USAGE: %s [options] <benchmark>\n\n  where <benchmark> is 'decay' or 'scan'.\n");
+
+    IntOption    reps("BENCH", "reps", "Passes over the inputs.\n", 200, IntRange(1, INT32_MAX));
+    DoubleOption mean("BENCH", "mean", "Mean age for 'decay'.\n", 200, DoubleRange(1, false, HUGE_VAL, false));
+    IntOption    len ("BENCH", "len",  "Clause length for 'scan'.\n", 32, IntRange(1, 1 << 16));
+    IntOption    stop("BENCH", "stop", "Position of the first non-false literal for 'scan' (-1 = uniform).\n", -1, IntRange(-1, 1 << 16));
+    IntOption    vars("BENCH", "vars", "Variables for 'scan' (the assignment is read from memory of that size).\n", 100000, IntRange(1, 1 << 28));
+
+    parseOptions(argc, argv, true);
+
+    if (argc < 2)
+        printf("ERROR! No benchmark given. Use '--help' for help.\n"), exit(1);
+    if (strcmp(argv[1], "decay") == 0)
+        benchDecay(reps, mean);
+    else if (strcmp(argv[1], "scan") == 0)
+        benchScan(reps, len, stop, vars);
+    else
+        printf("ERROR! Unknown benchmark: %s\n", argv[1]), exit(1);
+    return 0;
+}
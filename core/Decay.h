@@ -0,0 +1,42 @@
+/*****************************************************************************************[Decay.h]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Minisat_Decay_h
+#define Minisat_Decay_h
+
+#include "../mtl/IntTypes.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// Anti-exploration decay:
+//
+// Powers of the decay factor 0.95, so that no 'pow()' is needed when a variable is decayed for the
+// conflicts it spent unassigned: 0.95^age = decay_lo[age % 256] * decay_hi[age / 256]. From
+// 'decay_ages' on, the factor is below the smallest double anyway. (The tables are filled in at
+// startup, in 'Solver.cc'.)
+
+enum { decay_ages = 256 * 64 };
+extern double decay_lo[256], decay_hi[64];
+
+static inline double decayFactor(uint64_t age) {
+    return age < decay_ages ? decay_lo[age & 255] * decay_hi[age >> 8] : 0; }
+
+//=================================================================================================
+}
+
+#endif
@@ -42,6 +42,8 @@ static void readClause(B& in, Solver& S, vec<Lit>& lits) {
         while (var >= S.nVars()) S.newVar();
         lits.push( (parsed_lit > 0) ? mkLit(var) : ~mkLit(var) );
     }
+    if (lits.size() > Clause::max_size)
+        fprintf(stderr, "PARSE ERROR! Clause of more than %d literals\n", (int)Clause::max_size), exit(3);
 }
 
 template<class B, class Solver>
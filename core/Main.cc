@@ -27,6 +27,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "../utils/ParseUtils.h"
 #include "../utils/Options.h"
 #include "../core/Dimacs.h"
+#include "../core/SimdScan.h"
 #include "../core/Solver.h"
 using namespace Minisat;
 
@@ -85,6 +86,7 @@ int main(int argc, char** argv)
         IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", INT32_MAX, IntRange(0, INT32_MAX));
         
         parseOptions(argc, argv, true);
+        selectSimdScan();
 
         Solver S;
         double initial_time = cpuTime();
@@ -0,0 +1,144 @@
+/*************************************************************************************[SimdScan.cc]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "../core/SimdScan.h"
+#include "../utils/Options.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_SCAN_AVX2 1
+#include <immintrin.h>
+#endif
+
+using namespace Minisat;
+
+//=================================================================================================
+// Scalar scanners:
+
+
+static int scanNotFalseScalar(const Lit* lits, int n, const lbool* assigns)
+{
+    for (int i = 0; i < n; i++)
+        if ((assigns[var(lits[i])] ^ sign(lits[i])) != l_False)
+            return i;
+    return n;
+}
+
+
+static int scanTrueScalar(const Lit* lits, int n, const lbool* assigns)
+{
+    for (int i = 0; i < n; i++)
+        if ((assigns[var(lits[i])] ^ sign(lits[i])) == l_True)
+            return i;
+    return n;
+}
+
+
+#if SIMD_SCAN_AVX2
+//=================================================================================================
+// AVX2 scanners:
+//
+// A literal is 2 * var + sign, so shifting eight of them right by one gives the indices to gather the
+// assignment bytes of their variables with. The value of each literal is its assignment (low byte)
+// xor its sign, which is 0 for true and 1 for false ('l_True' and 'l_False'; undefined is 2 or 3).
+// Two gathers are issued per step, since a single one leaves most of its latency exposed.
+
+
+// Bit 'k' of the result is set if literal 'k' of the eight at 'lits' has the value 'v':
+__attribute__((target("avx2")))
+static inline unsigned valueMask(const Lit* lits, const lbool* assigns, lbool v)
+{
+    __m256i l = _mm256_loadu_si256((const __m256i*)lits);
+    __m256i a = _mm256_i32gather_epi32((const int*)assigns, _mm256_srli_epi32(l, 1), 1);
+    __m256i x = _mm256_xor_si256(_mm256_and_si256(a, _mm256_set1_epi32(0xff)), _mm256_and_si256(l, _mm256_set1_epi32(1)));
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, _mm256_set1_epi32(toInt(v)))));
+}
+
+
+__attribute__((target("avx2")))
+static int scanNotFalseAvx2(const Lit* lits, int n, const lbool* assigns)
+{
+    int i = 0;
+    for (; i + 2*scan_block <= n; i += 2*scan_block){
+        unsigned m = ~(valueMask(lits + i, assigns, l_False) | valueMask(lits + i + scan_block, assigns, l_False) << scan_block) & 0xffff;
+        if (m != 0)
+            return i + __builtin_ctz(m); }
+    if (i + scan_block <= n){
+        unsigned m = ~valueMask(lits + i, assigns, l_False) & 0xff;
+        if (m != 0)
+            return i + __builtin_ctz(m);
+        i += scan_block; }
+    return i + scanNotFalseScalar(lits + i, n - i, assigns);
+}
+
+
+__attribute__((target("avx2")))
+static int scanTrueAvx2(const Lit* lits, int n, const lbool* assigns)
+{
+    int i = 0;
+    for (; i + 2*scan_block <= n; i += 2*scan_block){
+        unsigned m = valueMask(lits + i, assigns, l_True) | valueMask(lits + i + scan_block, assigns, l_True) << scan_block;
+        if (m != 0)
+            return i + __builtin_ctz(m); }
+    if (i + scan_block <= n){
+        unsigned m = valueMask(lits + i, assigns, l_True);
+        if (m != 0)
+            return i + __builtin_ctz(m);
+        i += scan_block; }
+    return i + scanTrueScalar(lits + i, n - i, assigns);
+}
+#endif
+
+
+//=================================================================================================
+// Dispatch:
+
+
+bool Minisat::simdScanAvailable()
+{
+#if SIMD_SCAN_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+
+int (*Minisat::scanNotFalseBlocks)(const Lit*, int, const lbool*) = scanNotFalseScalar;
+int (*Minisat::scanTrueBlocks)    (const Lit*, int, const lbool*) = scanTrueScalar;
+
+
+void Minisat::setSimdScan(bool b)
+{
+    scanNotFalseBlocks = scanNotFalseScalar;
+    scanTrueBlocks     = scanTrueScalar;
+#if SIMD_SCAN_AVX2
+    if (b && simdScanAvailable()){
+        scanNotFalseBlocks = scanNotFalseAvx2;
+        scanTrueBlocks     = scanTrueAvx2; }
+#endif
+}
+
+
+const char* Minisat::simdScanName() { return scanNotFalseBlocks == scanNotFalseScalar ? "scalar" : "avx2"; }
+
+
+static struct SimdScanInit { SimdScanInit() { setSimdScan(true); } } simd_scan_init;
+
+
+static BoolOption opt_simd_scan("CORE", "simd", "Scan long clauses with AVX2 gathers if the CPU supports them", true);
+
+void Minisat::selectSimdScan() { setSimdScan(opt_simd_scan); }
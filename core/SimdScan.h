@@ -0,0 +1,91 @@
+/**************************************************************************************[SimdScan.h]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Minisat_SimdScan_h
+#define Minisat_SimdScan_h
+
+#include "../core/SolverTypes.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// Scanning the literals of a clause for one that is not false (or that is true):
+//
+// The first 'scan_head' literals are checked one by one, since most scans stop there. The rest of a
+// long clause is scanned in blocks of eight literals with AVX2 gathers from 'assigns', if the CPU
+// has AVX2 (checked once at startup); otherwise, and for the last few literals, one by one again.
+//
+// NOTE: the gathers read four bytes at '&assigns[var(p)]', so the assignment array must be readable
+// for three bytes beyond its last variable (see 'Solver::newVar()').
+
+enum { scan_head = 8, scan_block = 8 };
+
+// Index of the first of the 'n' literals at 'lits' that is not false ('n' if there is none):
+static inline int scanNotFalse(const Lit* lits, int n, const lbool* assigns);
+// Index of the first of them that is true ('n' if there is none):
+static inline int scanTrue    (const Lit* lits, int n, const lbool* assigns);
+
+// Block scanners of the rest (from 'scan_head' on); selected at startup:
+extern int (*scanNotFalseBlocks)(const Lit* lits, int n, const lbool* assigns);
+extern int (*scanTrueBlocks)    (const Lit* lits, int n, const lbool* assigns);
+
+bool        simdScanAvailable();    // TRUE if the CPU has AVX2.
+void        setSimdScan      (bool b); // Use the AVX2 scanners if available, or always the scalar ones.
+const char* simdScanName     ();    // The scanners in use ("avx2" or "scalar").
+
+// Applies the '-simd' option. The scanners are shared by all solvers of the process, so this is
+// called once from 'main()', after 'parseOptions()' and before any solver runs (without the call,
+// the AVX2 scanners are used if available):
+void        selectSimdScan   ();
+
+
+//=================================================================================================
+// Implementation of inline methods:
+
+static inline int scanNotFalse(const Lit* lits, int n, const lbool* assigns)
+{
+    int i = 0;
+    for (; i < n && i < scan_head; i++)
+        if ((assigns[var(lits[i])] ^ sign(lits[i])) != l_False)
+            return i;
+    if (n - i >= scan_block)
+        return i + scanNotFalseBlocks(lits + i, n - i, assigns);
+    for (; i < n; i++)
+        if ((assigns[var(lits[i])] ^ sign(lits[i])) != l_False)
+            return i;
+    return n;
+}
+
+
+static inline int scanTrue(const Lit* lits, int n, const lbool* assigns)
+{
+    int i = 0;
+    for (; i < n && i < scan_head; i++)
+        if ((assigns[var(lits[i])] ^ sign(lits[i])) == l_True)
+            return i;
+    if (n - i >= scan_block)
+        return i + scanTrueBlocks(lits + i, n - i, assigns);
+    for (; i < n; i++)
+        if ((assigns[var(lits[i])] ^ sign(lits[i])) == l_True)
+            return i;
+    return n;
+}
+
+//=================================================================================================
+}
+
+#endif
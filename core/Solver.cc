@@ -21,12 +21,29 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <math.h>
 #include <mpi.h>
 #include <iostream>
-#include <set>
 #include "../mtl/Sort.h"
 #include "../core/Solver.h"
+#include "../core/SimdScan.h"
+#include "../core/Decay.h"
+#include "../utils/System.h"
 #include <fstream>
+#if PROPAGATE_CYCLES
+#include <x86intrin.h>
+#endif
 using namespace Minisat;
 
+//=================================================================================================
+// Anti-exploration decay (see 'Decay.h'):
+
+
+double Minisat::decay_lo[256], Minisat::decay_hi[64];
+
+static struct DecayTables {
+    DecayTables() {
+        for (int i = 0; i < 256; i++) decay_lo[i] = pow(0.95, i);
+        for (int i = 0; i < 64;  i++) decay_hi[i] = pow(0.95, 256.0 * i); }
+} decay_tables;
+
 //=================================================================================================
 // Options:
 
@@ -47,12 +64,45 @@ static DoubleOption  opt_clause_decay      (_cat, "cla-decay",   "The clause act
 static DoubleOption  opt_random_var_freq   (_cat, "rnd-freq",    "The frequency with which the decision heuristic tries to choose a random variable", 0, DoubleRange(0, true, 1, true));
 static DoubleOption  opt_random_seed       (_cat, "rnd-seed",    "Used by the random variable selection",         91648253, DoubleRange(0, false, HUGE_VAL, false));
 static IntOption     opt_ccmin_mode        (_cat, "ccmin-mode",  "Controls conflict clause minimization (0=none, 1=basic, 2=deep)", 2, IntRange(0, 2));
+static IntOption     opt_bin_min_lbd       (_cat, "bin-min-lbd", "Minimize learnt clauses up to this LBD with binary clauses (0=never)", 6, IntRange(0, INT32_MAX));
+static IntOption     opt_bin_min_size      (_cat, "bin-min-size","Minimize learnt clauses up to this size with binary clauses", 30, IntRange(0, INT32_MAX));
+static BoolOption    opt_shrink            (_cat, "shrink",      "Shrink learnt clauses to one literal per level where possible (all-UIP)", false);
 static IntOption     opt_phase_saving      (_cat, "phase-saving", "Controls the level of phase saving (0=none, 1=limited, 2=full)", 2, IntRange(0, 2));
 static BoolOption    opt_rnd_init_act      (_cat, "rnd-init",    "Randomize the initial activity", false);
+static BoolOption    opt_vmtf              (_cat, "vmtf",        "Decide with a variable-move-to-front queue instead of the activity heap", false);
 static BoolOption    opt_luby_restart      (_cat, "luby",        "Use the Luby restart sequence", true);
 static IntOption     opt_restart_first     (_cat, "rfirst",      "The base restart interval", 100, IntRange(1, INT32_MAX));
 static DoubleOption  opt_restart_inc       (_cat, "rinc",        "Restart interval increase factor", 2, DoubleRange(1, false, HUGE_VAL, false));
+static IntOption     opt_restart_mode      (_cat, "restarts",    "Restart policy (0=luby/geometric, 1=LBD averages, 2=alternate stable (0) and focused (1) phases)", 0, IntRange(0, 2));
+static DoubleOption  opt_lbd_ema_fast      (_cat, "lbd-fast",    "Smoothing factor of the fast LBD average", 1.0/32, DoubleRange(0, false, 1, true));
+static DoubleOption  opt_lbd_ema_slow      (_cat, "lbd-slow",    "Smoothing factor of the slow LBD average", 1e-4, DoubleRange(0, false, 1, true));
+static DoubleOption  opt_restart_margin    (_cat, "rmargin",     "Restart if the fast LBD average times this factor exceeds the slow one", 0.8, DoubleRange(0, false, HUGE_VAL, false));
+static DoubleOption  opt_restart_block     (_cat, "rblock",      "Block restarts while the trail exceeds its average by this factor", 1.4, DoubleRange(1, true, HUGE_VAL, true));
+static IntOption     opt_restart_min       (_cat, "rmin",        "Minimal number of conflicts between LBD based restarts", 50, IntRange(1, INT32_MAX));
+static IntOption     opt_mode_first        (_cat, "mode-first",  "Conflicts of the first focused phase of restart policy 2", 1000, IntRange(1, INT32_MAX));
+static DoubleOption  opt_mode_inc          (_cat, "mode-inc",    "Phase length increase factor of restart policy 2", 2, DoubleRange(1, true, HUGE_VAL, false));
+static IntOption     opt_chrono            (_cat, "chrono",      "Backtrack chronologically if a conflict jumps more than this many levels (-1=never)", -1, IntRange(-1, INT32_MAX));
+static IntOption     opt_confl_to_chrono   (_cat, "confl-to-chrono", "Conflicts before chronological backtracking is allowed", 4000, IntRange(0, INT32_MAX));
+static BoolOption    opt_reuse_trail       (_cat, "reuse-trail", "Keep the decision levels on restarts that would be decided again", false);
+static BoolOption    opt_vivify            (_cat, "vivify",      "Vivify kept learnt and shared clauses at restarts", true);
+static IntOption     opt_vivify_int        (_cat, "vivify-int",  "Minimal number of conflicts between vivification passes", 5000, IntRange(1, INT32_MAX));
+static DoubleOption  opt_vivify_eff        (_cat, "vivify-eff",  "Propagations of a vivification pass relative to those of search", 0.1, DoubleRange(0, false, HUGE_VAL, false));
+#if TIERED_CLAUSE_DB
+static IntOption     opt_core_lbd          (_cat, "core-lbd",    "Keep learnt and shared clauses up to this LBD forever", 2, IntRange(0, INT32_MAX));
+static IntOption     opt_tier2_lbd         (_cat, "tier2-lbd",   "Keep learnt and shared clauses up to this LBD while they are used", 4, IntRange(0, INT32_MAX));
+#endif
+static IntOption     opt_prefetch_dist     (_cat, "prefetch-dist", "Prefetch the clauses of the watchers this many entries ahead in propagation (0=off)", 2, IntRange(0, 64));
 static DoubleOption  opt_garbage_frac      (_cat, "gc-frac",     "The fraction of wasted memory allowed before a garbage collection is triggered",  0.20, DoubleRange(0, false, HUGE_VAL, false));
+static BoolOption    opt_compact_gc        (_cat, "compact-gc",  "Compact the clause arena in place on garbage collection, instead of copying it into a new one", false);
+static IntOption     opt_gc_step           (_cat, "gc-step",     "Collect garbage incrementally, moving this many words of clauses per search iteration (0=stop the world)", 0, IntRange(0, INT32_MAX));
+static IntOption     opt_arena_gb          (_cat, "arena-gb",    "Reserve this many GB of address space for the clause arena, which then grows without copying and is compacted in place (0=off)", 0, IntRange(0, INT32_MAX));
+static BoolOption    opt_arena_thp         (_cat, "arena-thp",   "Back the reserved clause arena with transparent huge pages", false);
+static BoolOption    opt_walk              (_cat, "walk",        "Search by local search (ProbSAT) instead of CDCL (cannot prove unsatisfiability)", false);
+static IntOption     opt_walk_flips        (_cat, "walk-flips",  "Flips of local search per search iteration", 100, IntRange(1, INT32_MAX));
+static IntOption     opt_target            (_cat, "target",      "Decide with the phases of the largest conflict free trail (0=never, 1=in stable phases of restart policy 2, 2=always)", 1, IntRange(0, 2));
+static StringOption  opt_rephase           (_cat, "rephase",     "Rephasing schedule, cycled over: (O)riginal, (I)nverted, (B)est, (R)andom or (W)alk phases (empty=never)", "");
+static IntOption     opt_rephase_int       (_cat, "rephase-int", "Conflicts before the first rephasing (the n-th interval is n times as long)", 1000, IntRange(1, INT32_MAX));
+static DoubleOption  opt_walk_cb           (_cat, "walk-cb",     "Break count exponent of the local search flip probabilities", 2.38, DoubleRange(0, false, HUGE_VAL, false));
 
 #if BRANCHING_HEURISTIC == CHB
 static DoubleOption  opt_reward_multiplier (_cat, "reward-multiplier", "Reward multiplier", 0.9, DoubleRange(0, true, 1, true));
@@ -83,12 +133,42 @@ Solver::Solver() :
   , random_seed      (opt_random_seed)
   , luby_restart     (opt_luby_restart)
   , ccmin_mode       (opt_ccmin_mode)
+  , bin_min_lbd      (opt_bin_min_lbd)
+  , bin_min_size     (opt_bin_min_size)
+  , shrink           (opt_shrink)
   , phase_saving     (opt_phase_saving)
   , rnd_pol          (false)
   , rnd_init_act     (opt_rnd_init_act)
+  , vmtf             (opt_vmtf)
   , garbage_frac     (opt_garbage_frac)
   , restart_first    (opt_restart_first)
   , restart_inc      (opt_restart_inc)
+  , restart_mode     (opt_restart_mode)
+  , lbd_ema_fast     (opt_lbd_ema_fast)
+  , lbd_ema_slow     (opt_lbd_ema_slow)
+  , restart_margin   (opt_restart_margin)
+  , restart_block    (opt_restart_block)
+  , restart_min      (opt_restart_min)
+  , mode_first       (opt_mode_first)
+  , mode_inc         (opt_mode_inc)
+  , chrono           (opt_chrono)
+  , confl_to_chrono  (opt_confl_to_chrono)
+  , reuse_trail      (opt_reuse_trail)
+  , vivify           (opt_vivify)
+  , vivify_int       (opt_vivify_int)
+  , vivify_eff       (opt_vivify_eff)
+  , prefetch_dist    (opt_prefetch_dist)
+  , compact_gc       (opt_compact_gc)
+  , gc_step          (opt_gc_step)
+  , walk             (opt_walk)
+  , walk_flips       (opt_walk_flips)
+  , target           (opt_target)
+  , rephase          (opt_rephase)
+  , rephase_int      (opt_rephase_int)
+#if TIERED_CLAUSE_DB
+  , core_lbd         (opt_core_lbd)
+  , tier2_lbd        (opt_tier2_lbd)
+#endif
 
     // Parameters (the rest):
     //
@@ -103,6 +183,14 @@ Solver::Solver() :
     //
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0)
   , dec_vars(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0), shared_literals(0)
+  , bin_implied(0), long_implied(0)
+  , blocked_restarts(0), mode_switches(0)
+  , chrono_backtracks(0), non_chrono_backtracks(0), reused_levels(0)
+  , vivify_rounds(0), vivified_clauses(0), vivified_lits(0)
+  , bin_min_lits(0), shrunk_lits(0)
+  , watch_visits(0), watch_cycles(0)
+  , search_allocs(0), gc_frees(0), gc_collections(0), gc_pauses(0), gc_forced(0), gc_max_pause(0)
+  , phase_imports(0), rephases(0)
 
   , lbd_calls(0)
 #if BRANCHING_HEURISTIC == CHB
@@ -118,12 +206,37 @@ Solver::Solver() :
   , var_inc            (1)
 #endif
   , watches            (WatcherDeleted(ca))
+  , watches_bin        (WatcherDeleted(ca))
   , qhead              (0)
+  , qhead_bin          (0)
   , simpDB_assigns     (-1)
   , simpDB_props       (0)
-  , order_heap         (VarOrderLt(activity))
+  , order_heap         (activity)
+  , vmtf_first         (var_Undef)
+  , vmtf_last          (var_Undef)
+  , vmtf_search        (var_Undef)
+  , vmtf_stamps        (0)
   , progress_estimate  (0)
   , remove_satisfied   (true)
+  , restart_wait       (0)
+  , stable             (false)
+  , next_switch        (0)
+  , mode_length        (0)
+  , next_vivify        (0)
+  , vivify_props       (0)
+  , gc_active          (false)
+  , gc_top             (0)
+  , gc_next            (0)
+  , gc_end             (0)
+  , gc_wasted          (0)
+  , gc_rounds          (0)
+  , gc_span            (0)
+  , gc_stamp           (0)
+  , walk_pending       (false)
+  , target_assigned    (0)
+  , best_assigned      (0)
+  , rephase_count      (0)
+  , next_rephase       (0)
 
     // Resource constraints:
     //
@@ -135,16 +248,21 @@ Solver::Solver() :
   , num_shared         (0)
 {
 //    std::cout<<"[drand value]: "<<random()<<"[rank]: "<<Mpi_rank<<std::endl;
-//    lfile.open(lFileName);
-//    sfile.open(sFileName);
-
+#if TIERED_CLAUSE_DB
+    num_tier[tier_Local] = num_tier[tier_Tier2] = num_tier[tier_Core] = 0;
+#endif
+    walker.cb = opt_walk_cb;
+    if (opt_arena_gb > 0 && !ca.map((uint64_t)opt_arena_gb << 30, opt_arena_thp))
+        printf("WARNING! Could not reserve %d GB for the clause arena.\n", (int)opt_arena_gb);
 }
 
 
 Solver::~Solver()
 {
+#if CLAUSE_LOG
     lfile.close();
     sfile.close();
+#endif
 }
 
 
@@ -160,12 +278,18 @@ Var Solver::newVar(bool sign, bool dvar)
     int v = nVars();
     watches  .init(mkLit(v, false));
     watches  .init(mkLit(v, true ));
+    watches_bin.init(mkLit(v, false));
+    watches_bin.init(mkLit(v, true ));
     assigns  .push(l_Undef);
+    assigns  .capacity(v+4);    // (the clause scans may read three bytes beyond the last variable)
     vardata  .push(mkVarData(CRef_Undef, 0));
     //activity .push(0);
     activity .push(rnd_init_act ? drand(random_seed) * 0.00001 : 0);
     seen     .push(0);
     polarity .push(sign);
+    orig_phase  .push(sign);
+    target_phase.push(sign);
+    best_phase  .push(sign);
     decision .push();
     trail    .capacity(v+1);
     lbd_seen.push(0);
@@ -182,6 +306,10 @@ Var Solver::newVar(bool sign, bool dvar)
 #endif
     total_actual_rewards.push(0);
     total_actual_count.push(0);
+    vmtf_prev .push(var_Undef);
+    vmtf_next .push(var_Undef);
+    vmtf_stamp.push(0);
+    vmtfEnqueue(v);
     setDecisionVar(v, dvar);
     return v;
 }
@@ -220,8 +348,9 @@ bool Solver::addClause_(vec<Lit>& ps)
 void Solver::attachClause(CRef cr) {
     const Clause& c = ca[cr];
     assert(c.size() > 1);
-    watches[~c[0]].push(Watcher(cr, c[1]));
-    watches[~c[1]].push(Watcher(cr, c[0]));
+    OccLists<Lit, vec<Watcher>, WatcherDeleted>& ws = c.size() == 2 ? watches_bin : watches;
+    ws[~c[0]].push(Watcher(cr, c[1]));
+    ws[~c[1]].push(Watcher(cr, c[0]));
     if (c.learnt()) learnts_literals += c.size();
     else if(c.shared()) shared_literals += c.size();
     else            clauses_literals += c.size(); }
@@ -230,14 +359,15 @@ void Solver::attachClause(CRef cr) {
 void Solver::detachClause(CRef cr, bool strict) {
     const Clause& c = ca[cr];
     assert(c.size() > 1);
+    OccLists<Lit, vec<Watcher>, WatcherDeleted>& ws = c.size() == 2 ? watches_bin : watches;
     
     if (strict){
-        remove(watches[~c[0]], Watcher(cr, c[1]));
-        remove(watches[~c[1]], Watcher(cr, c[0]));
+        remove(ws[~c[0]], Watcher(cr, c[1]));
+        remove(ws[~c[1]], Watcher(cr, c[0]));
     }else{
         // Lazy detaching: (NOTE! Must clean all watcher lists before garbage collecting this clause)
-        watches.smudge(~c[0]);
-        watches.smudge(~c[1]);
+        ws.smudge(~c[0]);
+        ws.smudge(~c[1]);
     }
 
     if (c.learnt()) learnts_literals -= c.size();
@@ -248,45 +378,59 @@ void Solver::detachClause(CRef cr, bool strict) {
 void Solver::removeClause(CRef cr) {
 
     Clause& c = ca[cr];
+#if TIERED_CLAUSE_DB
+    if (c.learnt() || c.shared()) num_tier[c.tier()]--;
+#endif
     if(c.learnt() && !c.shared()) {
         num_learnt--; //added by @lavleshm
-        std::string clstr = c.toString();
-        clstr.append(std::to_string((conflicts - c.getBirth())) + " " + std::to_string(c.getUSe()) + " " + std::to_string(c.getLbd()));
-//        clstr.append(" ");
-//        clstr.append(std::to_string(c.getUSe()));
-//        clstr.append(" ");
-        lfile << clstr <<"\n";
-//        std::cout <<"removel clause in " << lbd(c) <<" "<<std::to_string(lbd(c))<<"\n";
+#if CLAUSE_LOG
+        if (lfile.isOpen()) logClause(lfile, c);
+#endif
     }
     else if(c.shared()) {
         num_shared--;
-        std::string clstr = c.toString();
-        clstr.append(std::to_string((conflicts - c.getBirth())) + " " + std::to_string(c.getUSe()) + " " + std::to_string(c.getLbd()));
-//        clstr.append(" ");
-//        clstr.append(std::to_string(c.getUSe()));
-        sfile << clstr <<"\n";
+#if CLAUSE_LOG
+        if (sfile.isOpen()) logClause(sfile, c);
+#endif
     }
     detachClause(cr);
     // Don't leave pointers to free'd memory!
-    if (locked(c)) vardata[var(c[0])].reason = CRef_Undef;
+    Lit implied = impliedBy(c);
+    if (implied != lit_Undef) vardata[var(implied)].reason = CRef_Undef;
     c.mark(1); 
-    ca.free(cr);
+    if (gc_active && cr < gc_top){
+        // (moved already, so its space stays wasted after the collection)
+        CRef w = ca.wasted();
+        ca.free(cr);
+        gc_wasted += ca.wasted() - w;
+    }else
+        ca.free(cr);
 }
 
 
 bool Solver::satisfied(const Clause& c) const {
-    for (int i = 0; i < c.size(); i++)
-        if (value(c[i]) == l_True)
-            return true;
-    return false; }
+    return scanTrue((const Lit*)c, c.size(), &assigns[0]) < c.size(); }
 
 
-// Revert to the state at given level (keeping all assignment at 'level' but not beyond).
+// Revert to the state at given level (keeping all assignment at 'level' but not beyond). After a
+// chronological backtrack the trail is no longer sorted by level: literals of lower levels that were
+// implied late are kept and put back on the trail, and only the unassigned variables are rewarded.
 //
 void Solver::cancelUntil(int level) {
     if (decisionLevel() > level){
+        cancel_kept.clear();
         for (int c = trail.size()-1; c >= trail_lim[level]; c--){
             Var      x  = var(trail[c]);
+            if (vardata[x].level <= level){
+                cancel_kept.push(trail[c]);
+                continue; }
+            double   old_activity = activity[x];
+#if ANTI_EXPLORATION
+            // The decay for the conflicts before 'x' was assigned is applied here rather than in
+            // 'uncheckedEnqueue()', together with the reward:
+            activity[x] *= decayFactor(picked[x] - canceled[x]);
+            canceled[x] = conflicts;
+#endif
             uint64_t age = conflicts - picked[x];
             if (age > 0) {
                 double reward = ((double) conflicted[x]) / ((double) age);
@@ -296,31 +440,105 @@ void Solver::cancelUntil(int level) {
 #else
                 double adjusted_reward = reward;
 #endif
-                double old_activity = activity[x];
-                activity[x] = step_size * adjusted_reward + ((1 - step_size) * old_activity);
-                if (order_heap.inHeap(x)) {
-                    if (activity[x] > old_activity)
-                        order_heap.decrease(x);
-                    else
-                        order_heap.increase(x);
-                }
+                activity[x] = step_size * adjusted_reward + ((1 - step_size) * activity[x]);
 #endif
                 total_actual_rewards[x] += reward;
                 total_actual_count[x] ++;
             }
-#if ANTI_EXPLORATION
-            canceled[x] = conflicts;
-#endif
+            if (activity[x] != old_activity)
+                order_updates.push(x);
             assigns [x] = l_Undef;
             if (phase_saving > 1 || (phase_saving == 1) && c > trail_lim.last())
                 polarity[x] = sign(trail[c]);
             insertVarOrder(x); }
-        qhead = trail_lim[level];
+        qhead = qhead_bin = trail_lim[level];
         trail.shrink(trail.size() - trail_lim[level]);
         trail_lim.shrink(trail_lim.size() - level);
+        for (int i = cancel_kept.size() - 1; i >= 0; i--)
+            trail.push_(cancel_kept[i]);
+        order_heap.updateMany(order_updates);
+        order_updates.clear();
     } }
 
 
+// Returns the highest decision level among the literals of the conflict clause 'confl' and moves
+// one literal of that level to the front, keeping the watches consistent. 'single' is set if no
+// other literal was assigned at that level, in which case the clause is asserting one level below
+// and the literal of the next highest level is moved to the second position.
+int Solver::conflictLevel(CRef confl, bool& single)
+{
+    Clause& c       = ca[confl];
+    int     highest = level(var(c[0]));
+    single = false;
+    if (highest == decisionLevel() && level(var(c[1])) == highest)
+        return highest;
+
+    int max_i = 0;
+    single = true;
+    for (int i = 1; i < c.size(); i++){
+        int l = level(var(c[i]));
+        if (l > highest){
+            highest = l;
+            max_i   = i;
+            single  = true;
+        }else if (l == highest)
+            single  = false;
+    }
+
+    if (max_i != 0){
+        Lit p = c[max_i];
+        c[max_i] = c[0];
+        c[0]     = p;
+        if (max_i > 1){
+            // The old first literal is no longer watched:
+            remove(watches[~c[max_i]], Watcher(confl, c[1]));
+            watches[~c[0]].push(Watcher(confl, c[1])); }
+    }
+
+    if (single && c.size() > 2){
+        int next_i = 1;
+        for (int i = 2; i < c.size(); i++)
+            if (level(var(c[i])) > level(var(c[next_i])))
+                next_i = i;
+        if (next_i != 1){
+            remove(watches[~c[1]], Watcher(confl, c[0]));
+            Lit p = c[next_i];
+            c[next_i] = c[1];
+            c[1]      = p;
+            watches[~c[1]].push(Watcher(confl, c[0])); }
+    }
+    return highest;
+}
+
+
+// Trail reuse on restarts: the decisions made after a restart would pick the variables of the heap in
+// order of activity, so all levels whose decision is more active than the best unassigned variable
+// would be reconstructed as they are. Returns the number of such levels (above the assumptions).
+int Solver::reuseTrailLevel()
+{
+    int level = assumptions.size() < decisionLevel() ? assumptions.size() : decisionLevel();
+    if (vmtf){
+        // (the same with the VMTF queue, where later in the queue means decided first)
+        Var next = vmtfNextVar();
+        if (next == var_Undef)
+            return 0;
+        while (level < decisionLevel() && vmtf_stamp[var(trail[trail_lim[level]])] > vmtf_stamp[next])
+            level++;
+        return level;
+    }
+
+    while (!order_heap.empty() && (value(order_heap[0]) != l_Undef || !decision[order_heap[0]]))
+        order_heap.removeMin();
+    if (order_heap.empty())
+        return 0;
+
+    double next = activity[order_heap[0]];
+    while (level < decisionLevel() && activity[var(trail[trail_lim[level]])] > next)
+        level++;
+    return level;
+}
+
+
 //=================================================================================================
 // Major methods:
 
@@ -330,11 +548,15 @@ Lit Solver::pickBranchLit()
     Var next = var_Undef;
 
     // Random decision:
-    if (drand(random_seed) < random_var_freq && !order_heap.empty()){
-        next = order_heap[irand(random_seed,order_heap.size())];
+    if (drand(random_seed) < random_var_freq && (vmtf ? nVars() > 0 : !order_heap.empty())){
+        next = vmtf ? irand(random_seed, nVars()) : order_heap[irand(random_seed,order_heap.size())];
         if (value(next) == l_Undef && decision[next])
             rnd_decisions++; }
 
+    // VMTF decision:
+    if (vmtf && (next == var_Undef || value(next) != l_Undef || !decision[next]))
+        next = vmtfNextVar();
+
     // Activity based decision:
     while (next == var_Undef || value(next) != l_Undef || !decision[next])
         if (order_heap.empty()){
@@ -342,23 +564,22 @@ Lit Solver::pickBranchLit()
             break;
         } else {
 #if ANTI_EXPLORATION
+            // Decay the candidates at the top until one is up to date. Assigned variables are
+            // removed below and decayed when they are unassigned:
             next = order_heap[0];
-            uint64_t age = conflicts - canceled[next];
-            while (age > 0) {
-                double decay = pow(0.95, age);
-                activity[next] *= decay;
-                if (order_heap.inHeap(next)) {
-                    order_heap.increase(next);
-                }
+            while (value(next) == l_Undef && canceled[next] != conflicts) {
+                activity[next] *= decayFactor(conflicts - canceled[next]);
                 canceled[next] = conflicts;
+                order_heap.increase(next);
                 next = order_heap[0];
-                age = conflicts - canceled[next];
             }
 #endif
             next = order_heap.removeMin();
         }
 
-    return next == var_Undef ? lit_Undef : mkLit(next, rnd_pol ? drand(random_seed) < 0.5 : polarity[next]);
+    if (next == var_Undef) return lit_Undef;
+    if (rnd_pol) return mkLit(next, drand(random_seed) < 0.5);
+    return mkLit(next, target == 2 || (target == 1 && restart_mode == 2 && stable) ? target_phase[next] : polarity[next]);
 }
 
 /*_________________________________________________________________________________________________
@@ -387,12 +608,23 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
     //
     out_learnt.push();      // (leave room for the asserting literal)
     int index   = trail.size() - 1;
+    int conflict_level = level(var(ca[confl][0]));  // (see 'conflictLevel()')
 
     do{
         assert(confl != CRef_Undef); // (otherwise should be UIP)
         Clause& c = ca[confl];
+        if (p != lit_Undef) normalizeReason(c, var(p));
         if(c.learnt() || c.shared()) c.incUse(); //added by @lavleshm
-#if LBD_BASED_CLAUSE_DELETION
+#if TIERED_CLAUSE_DB
+        // Used clauses stay in tier2 and are promoted when their LBD drops:
+        if ((c.learnt() || c.shared()) && c.tier() != tier_Core){
+            c.used(true);
+            int l = lbd(c);
+            if (l < c.activity()){
+                c.activity() = l;
+                if (tierOf(l) > c.tier()) setTier(c, tierOf(l)); }
+        }
+#elif LBD_BASED_CLAUSE_DELETION
         if ((c.learnt() || c.shared()) && c.activity() > 2)
             c.activity() = lbd(c);
 #else
@@ -410,17 +642,20 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
                 varBumpActivity(var(q));
 #endif
                 conflicted[var(q)]++;
+                if (vmtf) vmtf_bumped.push(var(q));
                 seen[var(q)] = 1;
-                if (level(var(q)) >= decisionLevel())
+                if (level(var(q)) >= conflict_level)
                     pathC++;
                 else
                     out_learnt.push(q);
             }
         }
         
-        // Select next clause to look at:
-        while (!seen[var(trail[index--])]);
-        p     = trail[index+1];
+        // Select next clause to look at (skipping lower levels that were implied late):
+        do{
+            while (!seen[var(trail[index--])]);
+            p     = trail[index+1];
+        }while (level(var(p)) < conflict_level);
         confl = reason(var(p));
         seen[var(p)] = 0;
         pathC--;
@@ -448,7 +683,8 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
             if (reason(x) == CRef_Undef)
                 out_learnt[j++] = out_learnt[i];
             else{
-                Clause& c = ca[reason(var(out_learnt[i]))];
+                Clause& c = ca[reason(x)];
+                normalizeReason(c, x);
                 for (int k = 1; k < c.size(); k++)
                     if (!seen[var(c[k])] && level(var(c[k])) > 0){
                         out_learnt[j++] = out_learnt[i];
@@ -460,6 +696,10 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
 
     max_literals += out_learnt.size();
     out_learnt.shrink(i - j);
+    if (out_learnt.size() > 1 && out_learnt.size() <= bin_min_size && watches_bin[~out_learnt[0]].size() > 0 && lbd(out_learnt) <= bin_min_lbd)
+        binResMinimize(out_learnt);
+    if (shrink && out_learnt.size() > 2)
+        shrinkLevels(out_learnt);
     tot_literals += out_learnt.size();
 
     // Find correct backtrack level:
@@ -479,6 +719,8 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
         out_btlevel       = level(var(p));
     }
 
+    if (vmtf) vmtfBump();
+
 #if ALMOST_CONFLICT
     seen[var(p)] = true;
     for(int i = out_learnt.size() - 1; i >= 0; i--) {
@@ -509,7 +751,8 @@ bool Solver::litRedundant(Lit p, uint32_t abstract_levels)
     int top = analyze_toclear.size();
     while (analyze_stack.size() > 0){
         assert(reason(var(analyze_stack.last())) != CRef_Undef);
-        Clause& c = ca[reason(var(analyze_stack.last()))]; analyze_stack.pop();
+        Clause& c = ca[reason(var(analyze_stack.last()))];
+        normalizeReason(c, var(analyze_stack.last())); analyze_stack.pop();
 
         for (int i = 1; i < c.size(); i++){
             Lit p  = c[i];
@@ -532,6 +775,99 @@ bool Solver::litRedundant(Lit p, uint32_t abstract_levels)
 }
 
 
+// Removes the literals 'q' of a learnt clause for which '~out_learnt[0] -> ~q' is a binary clause:
+// resolving on 'q' gives the clause without it. The marks in 'seen' are those set by 'analyze()'.
+void Solver::binResMinimize(vec<Lit>& out_learnt)
+{
+    for (int i = 1; i < out_learnt.size(); i++)
+        seen[var(out_learnt[i])] = 2;
+
+    vec<Watcher>& wbin = watches_bin.lookup(~out_learnt[0]);
+    int removed = 0;
+    for (int k = 0; k < wbin.size(); k++){
+        Lit imp = wbin[k].blocker;
+        if (seen[var(imp)] == 2 && value(imp) == l_True){
+            seen[var(imp)] = 3;
+            removed++; }
+    }
+
+    int i, j;
+    for (i = j = 1; i < out_learnt.size(); i++){
+        Var x = var(out_learnt[i]);
+        if (seen[x] != 3)
+            out_learnt[j++] = out_learnt[i];
+        seen[x] = 1; }
+    out_learnt.shrink(i - j);
+    bin_min_lits += removed;
+}
+
+
+// All-UIP shrinking: the literals of a learnt clause that share a decision level (other than the
+// asserting one) are replaced by a single literal of that level which implies them, provided that
+// no literal of another level is needed for it. This keeps the LBD and reduces the size.
+void Solver::shrinkLevels(vec<Lit>& out_learnt)
+{
+    sort(&out_learnt[1], out_learnt.size() - 1, LevelGt(vardata));
+    for (int i = 1; i < out_learnt.size(); i++)
+        seen[var(out_learnt[i])] = 2;
+
+    // Levels are handled from the highest down, since the literals of a level only depend on
+    // lower ones:
+    shrink_lits.clear();
+    shrink_lits.push(out_learnt[0]);
+    for (int i = 1, j; i < out_learnt.size(); i = j){
+        int l = level(var(out_learnt[i]));
+        for (j = i + 1; j < out_learnt.size() && level(var(out_learnt[j])) == l; j++);
+        Lit uip = j - i > 1 ? levelUip(l, j - i) : lit_Undef;
+        if (uip != lit_Undef){
+            shrink_lits.push(uip);
+            shrunk_lits += j - i - 1;
+        }else
+            for (int k = i; k < j; k++)
+                shrink_lits.push(out_learnt[k]);
+    }
+    shrink_lits.copyTo(out_learnt);
+
+    for (int i = 1; i < out_learnt.size(); i++)
+        seen[var(out_learnt[i])] = 1;
+}
+
+
+// Returns the first UIP of the 'lits' literals of the learnt clause at level 'lvl' (marked with 2 in
+// 'seen'), or 'lit_Undef' if resolving up to it needs a literal of another level that is not in
+// the clause. Literals on the trail after the end of 'lvl' (kept by chronological backtracking)
+// are not visited, which makes the search fail rather than be wrong.
+Lit Solver::levelUip(int lvl, int lits)
+{
+    int pathC = lits;
+    int begin = trail_lim[lvl - 1];
+    for (int index = (lvl < decisionLevel() ? trail_lim[lvl] : trail.size()) - 1; index >= begin; index--){
+        Var v = var(trail[index]);
+        if (level(v) != lvl || seen[v] < 2)
+            continue;
+        if (pathC == 1)
+            return ~trail[index];
+        if (reason(v) == CRef_Undef)
+            return lit_Undef;
+
+        Clause& c = ca[reason(v)];
+        normalizeReason(c, v);
+        for (int k = 1; k < c.size(); k++){
+            Var x = var(c[k]);
+            if (level(x) == lvl){
+                if (seen[x] < 2){
+                    seen[x] = 3;
+                    analyze_toclear.push(c[k]);
+                    pathC++; }
+            }else if (level(x) > 0 && seen[x] != 2)
+                return lit_Undef;
+        }
+        pathC--;
+    }
+    return lit_Undef;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  analyzeFinal : (p : Lit)  ->  [void]
@@ -559,6 +895,7 @@ void Solver::analyzeFinal(Lit p, vec<Lit>& out_conflict)
                 out_conflict.push(~trail[i]);
             }else{
                 Clause& c = ca[reason(x)];
+                normalizeReason(c, x);
                 for (int j = 1; j < c.size(); j++)
                     if (level(var(c[j])) > 0)
                         seen[var(c[j])] = 1;
@@ -571,26 +908,16 @@ void Solver::analyzeFinal(Lit p, vec<Lit>& out_conflict)
 }
 
 
-void Solver::uncheckedEnqueue(Lit p, CRef from)
+void Solver::uncheckedEnqueue(Lit p, int level, CRef from)
 {
     assert(value(p) == l_Undef);
     picked[var(p)] = conflicts;
-#if ANTI_EXPLORATION
-    uint64_t age = conflicts - canceled[var(p)];
-    if (age > 0) {
-        double decay = pow(0.95, age);
-        activity[var(p)] *= decay;
-        if (order_heap.inHeap(var(p))) {
-            order_heap.increase(var(p));
-        }
-    }
-#endif
     conflicted[var(p)] = 0;
 #if ALMOST_CONFLICT
     almost_conflicted[var(p)] = 0;
 #endif
     assigns[var(p)] = lbool(!sign(p));
-    vardata[var(p)] = mkVarData(from, decisionLevel());
+    vardata[var(p)] = mkVarData(from, level);
     trail.push_(p);
 }
 
@@ -601,7 +928,8 @@ void Solver::uncheckedEnqueue(Lit p, CRef from)
 |  
 |  Description:
 |    Propagates all enqueued facts. If a conflict arises, the conflicting clause is returned,
-|    otherwise CRef_Undef.
+|    otherwise CRef_Undef. The binary clauses of all enqueued facts are propagated before the
+|    next fact is taken on to the long clauses.
 |  
 |    Post-conditions:
 |      * the propagation queue is empty, even if there was a conflict.
@@ -611,14 +939,56 @@ CRef Solver::propagate()
     CRef    confl     = CRef_Undef;
     int     num_props = 0;
     watches.cleanAll();
+    watches_bin.cleanAll();
 
     while (qhead < trail.size()){
+        // Binary implications of the whole trail segment first:
+        while (qhead_bin < trail.size()){
+            Lit            p    = trail[qhead_bin++];
+            int            lvl  = level(var(p));
+            vec<Watcher>&  wbin = watches_bin[p];
+            for (int k = 0; k < wbin.size(); k++){
+                Lit imp = wbin[k].blocker;
+                if (value(imp) == l_False){
+                    confl     = wbin[k].cref;
+                    qhead     = qhead_bin = trail.size();
+                    goto Done; }
+                if (value(imp) == l_Undef){
+                    bin_implied++;
+                    uncheckedEnqueue(imp, lvl, wbin[k].cref); }
+            }
+        }
+
         Lit            p   = trail[qhead++];     // 'p' is enqueued fact to propagate.
+        int            lvl = level(var(p));
         vec<Watcher>&  ws  = watches[p];
         Watcher        *i, *j, *end;
         num_props++;
+#if PROPAGATE_CYCLES
+        uint64_t       t0  = __rdtsc();
+        watch_visits += ws.size();
+#endif
+        // Most watch lists are short, so the pipeline also runs across the trail: the watchers of the
+        // next literal, and the list header of the one after it:
+        if (prefetch_dist > 0 && qhead < trail.size()){
+            const vec<Watcher>& next = watches[trail[qhead]];
+            if (next.size() > 0)
+                __builtin_prefetch(&next[0]);
+            if (qhead + 1 < trail.size())
+                __builtin_prefetch(&watches[trail[qhead + 1]]);
+        }
 
         for (i = j = (Watcher*)ws, end = i + ws.size();  i != end;){
+            // Software pipeline: the assignment of a blocker is prefetched '2 * prefetch_dist' watchers
+            // ahead, and the clause 'prefetch_dist' ahead unless that blocker turned out true. (The first
+            // literal of the clause is unknown before its memory arrives; the blocker usually equals it.)
+            if (prefetch_dist > 0){
+                if (end - i > 2*prefetch_dist)
+                    __builtin_prefetch(&assigns[var(i[2*prefetch_dist].blocker)]);
+                if (end - i > prefetch_dist && value(i[prefetch_dist].blocker) != l_True)
+                    __builtin_prefetch(&ca[i[prefetch_dist].cref]);
+            }
+
             // Try to avoid inspecting the clause:
             Lit blocker = i->blocker;
             if (value(blocker) == l_True){
@@ -640,27 +1010,45 @@ CRef Solver::propagate()
                 *j++ = w; continue; }
 
             // Look for new watch:
-            for (int k = 2; k < c.size(); k++)
-                if (value(c[k]) != l_False){
-                    c[1] = c[k]; c[k] = false_lit;
-                    watches[~c[1]].push(w);
-                    goto NextClause; }
+            int k = 2 + scanNotFalse((const Lit*)c + 2, c.size() - 2, assigns);
+            if (k < c.size()){
+                c[1] = c[k]; c[k] = false_lit;
+                watches[~c[1]].push(w);
+                goto NextClause; }
 
             // Did not find watch -- clause is unit under assignment:
             *j++ = w;
             if (value(first) == l_False){
                 confl = cr;
-                qhead = trail.size();
+                qhead = qhead_bin = trail.size();
                 // Copy the remaining watches:
                 while (i < end)
                     *j++ = *i++;
-            }else
-                uncheckedEnqueue(first, cr);
+            }else if (lvl == decisionLevel()){
+                long_implied++;
+                uncheckedEnqueue(first, lvl, cr);
+            }else{
+                // 'p' is from a lower level, so some other literal may fix the implication level.
+                // It becomes the second watch so that it is unassigned first:
+                int max_i = 1;
+                for (int k = 2; k < c.size(); k++)
+                    if (level(var(c[k])) > level(var(c[max_i])))
+                        max_i = k;
+                if (max_i != 1){
+                    c[1] = c[max_i]; c[max_i] = false_lit;
+                    j--;
+                    watches[~c[1]].push(w); }
+                long_implied++;
+                uncheckedEnqueue(first, level(var(c[1])), cr); }
 
         NextClause:;
         }
         ws.shrink(i - j);
+#if PROPAGATE_CYCLES
+        watch_cycles += __rdtsc() - t0;
+#endif
     }
+Done:
     propagations += num_props;
     simpDB_props -= num_props;
 
@@ -678,6 +1066,8 @@ int min(int a, int b) {
 |  Description:
 |    Remove half of the learnt clauses, minus the clauses locked by the current assignment. Locked
 |    clauses are clauses that are reason to some assignment. Binary clauses are never removed.
+|    With TIERED_CLAUSE_DB, only the local tier is reduced: core clauses are kept forever and tier2
+|    clauses are demoted to the local tier when they were not used since the last reduction.
 |________________________________________________________________________________________________@*/
 struct reduceDB_lt { 
     ClauseAllocator& ca;
@@ -695,6 +1085,46 @@ struct reduceDB_lt {
         return ca[x].size() > 2 && (ca[y].size() == 2 || ca[x].activity() < ca[y].activity()); } 
 #endif
 };
+#if TIERED_CLAUSE_DB
+// Demotes the tier2 clauses of 'cs' that were not used since the last reduction, and collects the
+// local ones that may be deleted. Local clauses that were used get another round.
+void Solver::collectLocal(vec<CRef>& cs)
+{
+    for (int i = 0; i < cs.size(); i++){
+        Clause& c = ca[cs[i]];
+        if (c.tier() == tier_Tier2 && !c.used())
+            setTier(c, tier_Local);
+        else if (c.tier() == tier_Local && !c.used() && !locked(c))
+            reduce_local.push(cs[i]);
+        c.used(false);
+    }
+}
+
+static void purgeRemoved(vec<CRef>& cs, const ClauseAllocator& ca)
+{
+    int i, j;
+    for (i = j = 0; i < cs.size(); i++)
+        if (ca[cs[i]].mark() != 1)
+            cs[j++] = cs[i];
+    cs.shrink(i - j);
+}
+
+void Solver::reduceDB()
+{
+    // Only the local tier is ordered; up to half of it (the clauses of highest LBD) is deleted:
+    int limit = num_tier[tier_Local] / 2;
+    reduce_local.clear();
+    collectLocal(learnts);
+    collectLocal(shareds);
+    sort(reduce_local, reduceDB_lt(ca, activity));
+    for (int i = 0; i < limit && i < reduce_local.size(); i++)
+        removeClause(reduce_local[i]);
+
+    purgeRemoved(learnts, ca);
+    purgeRemoved(shareds, ca);
+    checkGarbage();
+}
+#else
 void Solver::reduceDB()
 {
     int     i, j;
@@ -733,6 +1163,7 @@ void Solver::reduceDB()
         shareds.shrink(i - j);
     checkGarbage();
 }
+#endif
 
 
 void Solver::removeSatisfied(vec<CRef>& cs)
@@ -749,9 +1180,120 @@ void Solver::removeSatisfied(vec<CRef>& cs)
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  vivifyLearnts : [void]  ->  [bool]
+|  
+|  Description:
+|    Strengthens the learnt and shared clauses that are kept beyond the next reduction (the core and
+|    tier2 clauses) by probing: the negations of the literals of a clause are assigned one by one and
+|    propagated. A literal that becomes false is dropped; if one becomes true or a conflict arises,
+|    the literals assigned so far form the new clause. The clause itself stays attached: it can only
+|    imply its last literal, which yields no strengthening but is still sound. Every clause is vivified
+|    once; the pass stops after 'vivify_eff' times the propagations of search since the last pass.
+|    Must be called at the root level. Returns FALSE if the problem was found to be UNSAT.
+|________________________________________________________________________________________________@*/
+bool Solver::vivifyLearnts()
+{
+    assert(decisionLevel() == 0);
+    uint64_t prop_limit = propagations + (uint64_t)((propagations - vivify_props) * vivify_eff);
+    vivify_rounds++;
+    ok = vivifyClauses(learnts, prop_limit) && vivifyClauses(shareds, prop_limit);
+    next_vivify  = conflicts + vivify_int;
+    vivify_props = propagations;
+    return ok;
+}
+
+
+bool Solver::vivifyClauses(vec<CRef>& cs, uint64_t prop_limit)
+{
+    bool res = ok;
+    int  i, j;
+    for (i = j = 0; i < cs.size(); i++){
+        CRef    cr = cs[i];
+        Clause& c  = ca[cr];
+#if TIERED_CLAUSE_DB
+        bool kept = c.tier() != tier_Local;
+#else
+        bool kept = true;
+#endif
+        if (!res || !kept || c.vivified() || c.size() <= 2 || propagations >= prop_limit || satisfied(c)){
+            cs[j++] = cr;
+            continue; }
+
+        c.vivified(true);
+        // (propagation may reorder the literals of 'c', so they are probed from a copy)
+        vivify_lits.clear();
+        for (int k = 0; k < c.size(); k++)
+            vivify_lits.push(c[k]);
+        int n = 0;
+        for (int k = 0; k < vivify_lits.size(); k++){
+            Lit p = vivify_lits[k];
+            if (value(p) == l_False) continue;
+            vivify_lits[n++] = p;
+            if (value(p) == l_True) break;
+            newDecisionLevel();
+            uncheckedEnqueue(~p);
+            if (propagate() != CRef_Undef) break;
+        }
+        vivify_lits.shrink(vivify_lits.size() - n);
+        cancelProbes();
+
+        if (vivify_lits.size() == c.size()){
+            cs[j++] = cr;
+            continue; }
+        vivified_clauses++;
+        vivified_lits += c.size() - vivify_lits.size();
+
+        if (vivify_lits.size() <= 1){
+            // All but one literal are false at the root level:
+            removeClause(cr);
+            if (vivify_lits.size() == 0)
+                res = false;
+            else{
+                uncheckedEnqueue(vivify_lits[0]);
+                res = propagate() == CRef_Undef; }
+            continue; }
+
+        detachClause(cr, true);
+        for (int k = 0; k < vivify_lits.size(); k++)
+            c[k] = vivify_lits[k];
+        c.shrink(c.size() - vivify_lits.size());
+        attachClause(cr);
+#if LBD_BASED_CLAUSE_DELETION
+        if (c.activity() > c.size())
+            c.activity() = c.size();
+#endif
+#if TIERED_CLAUSE_DB
+        if (tierOf(c.activity()) > c.tier())
+            setTier(c, tierOf(c.activity()));
+#endif
+        cs[j++] = cr;
+    }
+    cs.shrink(i - j);
+    return res;
+}
+
+
+// Undoes the assignments of vivification. Unlike 'cancelUntil()', this leaves the activities, the
+// rewards and the saved phases alone: probing decisions say nothing about the search.
+void Solver::cancelProbes()
+{
+    if (decisionLevel() == 0) return;
+    for (int c = trail.size()-1; c >= trail_lim[0]; c--)
+        assigns[var(trail[c])] = l_Undef;
+    qhead = qhead_bin = trail_lim[0];
+    trail.shrink(trail.size() - trail_lim[0]);
+    trail_lim.clear();
+}
+
+
 void Solver::rebuildOrderHeap()
 {
-    vec<Var> vs;
+    if (vmtf) return;
+
+    vec<Var>& vs = rebuild_vars;
+    vs.clear();
     for (Var v = 0; v < nVars(); v++)
         if (decision[v] && value(v) == l_Undef)
             vs.push(v);
@@ -759,6 +1301,101 @@ void Solver::rebuildOrderHeap()
 }
 
 
+//=================================================================================================
+// Phases:
+//
+// Besides the saved phases in 'polarity', two assignments are kept: the target phases, of the largest
+// trail without a conflict since the last restart, and the best phases, of the largest one since the
+// last rephasing. In the stable phases of restart policy 2, decisions take the target phase ('target'),
+// which steers the search back to where it got furthest. Every so often, the saved phases are reset
+// by the next entry of the schedule 'rephase', which diversifies the search in a different way than
+// restarts do.
+
+
+void Solver::updatePhases(int consistent)
+{
+    if (consistent > target_assigned){
+        for (int i = 0; i < consistent; i++)
+            target_phase[var(trail[i])] = sign(trail[i]);
+        target_assigned = consistent; }
+    if (consistent > best_assigned){
+        for (int i = 0; i < consistent; i++)
+            best_phase[var(trail[i])] = sign(trail[i]);
+        best_assigned = consistent; }
+}
+
+
+void Solver::rephaseNext()
+{
+    char kind = rephase[rephase_count++ % rephase.size()];
+    if (kind == 'W' && !walk_pending)
+        kind = 'B';     // (no walk has handed on its phases since the last time)
+
+    for (Var v = 0; v < nVars(); v++)
+        switch (kind){
+        case 'O': polarity[v] = orig_phase[v];               break;
+        case 'I': polarity[v] = !orig_phase[v];              break;
+        case 'B': polarity[v] = best_phase[v];               break;
+        case 'R': polarity[v] = drand(random_seed) < 0.5;    break;
+        case 'W': polarity[v] = walk_phases[v];              break; }
+    if (kind == 'W')
+        walk_pending = false;
+
+    polarity.copyTo(target_phase);
+    target_assigned = best_assigned = 0;
+    next_rephase    = conflicts + (uint64_t)rephase_int * (rephase_count + 1);
+    rephases++;
+}
+
+
+//=================================================================================================
+// VMTF decision queue:
+//
+// Instead of the activity heap, the variables can be kept in a queue in the order in which they were
+// last bumped, i.e. seen in conflict analysis. The next decision is the most recently bumped unassigned
+// variable; 'vmtf_search' remembers where that search stopped, so that it is amortized over the
+// decisions and only moves back when a variable later in the queue becomes unassigned.
+
+
+void Solver::vmtfEnqueue(Var x)
+{
+    if (x != vmtf_last){
+        Var p = vmtf_prev[x], n = vmtf_next[x];
+        if (n != var_Undef){
+            // Unlink 'x' (it is not new):
+            if (p == var_Undef) vmtf_first = n; else vmtf_next[p] = n;
+            vmtf_prev[n] = p; }
+        vmtf_prev[x] = vmtf_last;
+        vmtf_next[x] = var_Undef;
+        if (vmtf_last == var_Undef) vmtf_first = x; else vmtf_next[vmtf_last] = x;
+        vmtf_last    = x;
+    }
+    vmtf_stamp[x] = ++vmtf_stamps;
+    if (vmtf_search == var_Undef || value(x) == l_Undef)
+        vmtf_search = x;
+}
+
+
+void Solver::vmtfBump()
+{
+    sort(vmtf_bumped, StampLt(vmtf_stamp));     // (keep their relative order)
+    for (int i = 0; i < vmtf_bumped.size(); i++)
+        vmtfEnqueue(vmtf_bumped[i]);
+    vmtf_bumped.clear();
+}
+
+
+Var Solver::vmtfNextVar()
+{
+    Var x = vmtf_search;
+    while (x != var_Undef && (value(x) != l_Undef || !decision[x]))
+        x = vmtf_prev[x];
+    if (x != var_Undef)
+        vmtf_search = x;
+    return x;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  simplify : [void]  ->  [bool]
@@ -809,22 +1446,31 @@ bool Solver::simplify()
     assert(ok);
     int         backtrack_level;
     int         conflictC = 0;
-    vec<Lit>    learnt_clause;
+    vec<Lit>&   learnt_clause = search_learnt;
     starts++;
+    restart_wait = restart_min;
 
     for (;;){
+#if ALLOC_COUNT
+        uint64_t allocs = allocCount(), frees = freeCount() - gc_frees;
+#endif
 
         iterations++;
+        if (gc_active) garbageStep();
         if(sharedClauseIn.size()> 0){
 
-            std::set<int> lbds;
+            // The distinct levels of the assigned literals are counted with the stamps of 'lbd()':
+            lbd_calls++;
+            int levels = 0;
             int undef_count = 0;
             int max_lvl = 0, lvl;
             bool isSatisfied = false;
             for (int i = 0; i < sharedClauseIn.size(); ++i) {
                 if(value(sharedClauseIn[i]) != l_Undef){
                     lvl = level(var(sharedClauseIn[i]));
-                    lbds.insert(lvl);
+                    if (lbd_seen[lvl] != lbd_calls){
+                        lbd_seen[lvl] = lbd_calls;
+                        levels++; }
                     if(lvl > max_lvl) max_lvl = lvl;
                     if(value(sharedClauseIn[i]) == l_True) {
                         isSatisfied = true;
@@ -855,12 +1501,17 @@ bool Solver::simplify()
 
             if(undef_count > 0) undef_count = 1;
             assert(sharedClauseIn.size() > 1);
-            if(/*sharedClauseIn.size() > 1 &&!isSatisfied &&*/(lbds.size()+undef_count) < 5){
-                CRef cr = ca.alloc(sharedClauseIn, false, 1, conflicts, 0, lbd(sharedClauseIn));
+            if(/*sharedClauseIn.size() > 1 &&!isSatisfied &&*/(levels+undef_count) < 5){
+                int  shared_lbd = lbd(sharedClauseIn);
+                CRef cr = ca.alloc(sharedClauseIn, false, 1, conflicts, 0, shared_lbd);
                 shareds.push(cr);
                 attachClause(cr);
                 num_shared++;
-                Clause &c = ca[cr];
+#if TIERED_CLAUSE_DB
+                ca[cr].activity() = shared_lbd;
+                num_tier[tier_Local]++;
+                setTier(ca[cr], tierOf(shared_lbd));
+#endif
 //                c.setBirth(conflicts);
 //                std::cout <<"received clause in " << lbd(c) <<(lbds.size()+undef_count) <<lbd(sharedClauseIn)<<"\n";
 //                for (int j = 0; j < sharedClauseIn.size(); ++j) {
@@ -883,31 +1534,57 @@ bool Solver::simplify()
             Var v = var(trail[a]);
             uint64_t age = conflicts - last_conflict[v] + 1;
             double reward = multiplier / age ;
-            double old_activity = activity[v];
-            activity[v] = step_size * reward + ((1 - step_size) * old_activity);
-            if (order_heap.inHeap(v)) {
-                if (activity[v] > old_activity)
-                    order_heap.decrease(v);
-                else
-                    order_heap.increase(v);
-            }
+            activity[v] = step_size * reward + ((1 - step_size) * activity[v]);
+            order_updates.push(v);
         }
+        order_heap.updateMany(order_updates);
+        order_updates.clear();
 #endif
         if (confl != CRef_Undef){
             // CONFLICT
             conflicts++; conflictC++;
+            if (decisionLevel() > 0) updatePhases(trail_lim.last());
 #if BRANCHING_HEURISTIC == CHB || BRANCHING_HEURISTIC == LRB
             if (step_size > min_step_size)
                 step_size -= step_size_dec;
 #endif
-            if (decisionLevel() == 0) {
+            bool single;
+            int  conflict_level = conflictLevel(confl, single);
+            if (conflict_level == 0) {
                // return l_False;
                ret_search_val = l_False;
                return;
             }
+            if (single){
+                // The conflict clause is asserting at the level of its second literal. Propagation goes on
+                // there, or right below its highest level if that is a chronological backtrack:
+                int assert_level = level(var(ca[confl][1]));
+                if (chrono >= 0 && conflicts >= (uint64_t)confl_to_chrono && decisionLevel() - assert_level > chrono)
+                    cancelUntil(conflict_level - 1);
+                else
+                    cancelUntil(assert_level);
+                uncheckedEnqueue(ca[confl][0], assert_level, confl);
+#if ALLOC_COUNT
+                checkSearchAllocs(allocs, frees);
+#endif
+                source();
+                continue;
+            }
 
             learnt_clause.clear();
             analyze(confl, learnt_clause, backtrack_level);
+            int learnt_lbd = learnt_clause.size() == 1 ? 1 : lbd(learnt_clause);
+
+            if (restart_mode != 0){
+                lbd_fast.update(learnt_lbd);
+                lbd_slow.update(learnt_lbd);
+                // Postpone the next restart while the trail is much larger than usual; the solver
+                // may be close to a model:
+                if (focused() && --restart_wait <= 0 && conflicts > 10000 && trail.size() > restart_block * trail_avg.value){
+                    restart_wait = restart_min;
+                    blocked_restarts++; }
+                trail_avg.update(trail.size());
+            }
 
             int buffer_len = learnt_clause.size();
             if(buffer_len <= 8 && learnt_clause.size() > 1){
@@ -925,16 +1602,21 @@ bool Solver::simplify()
 
 
 
-            cancelUntil(backtrack_level);
+            if (chrono >= 0 && conflicts >= (uint64_t)confl_to_chrono && decisionLevel() - backtrack_level > chrono){
+                chrono_backtracks++;
+                cancelUntil(conflict_level - 1);
+            }else{
+                non_chrono_backtracks++;
+                cancelUntil(backtrack_level); }
 
 #if BRANCHING_HEURISTIC == CHB
             action = trail.size();
 #endif
 
             if (learnt_clause.size() == 1){
-                uncheckedEnqueue(learnt_clause[0]);
+                uncheckedEnqueue(learnt_clause[0], 0, CRef_Undef);
             }else{
-                CRef cr = ca.alloc(learnt_clause, true, 0, conflicts,0 , lbd(learnt_clause));
+                CRef cr = ca.alloc(learnt_clause, true, 0, conflicts, 0, learnt_lbd);
                 learnts.push(cr);
                 attachClause(cr);
                 num_learnt++;
@@ -942,12 +1624,15 @@ bool Solver::simplify()
 //                std::cout <<"learnt clause in " << lbd(c) <<"\n";
 //                c.setBirth(conflicts);
 #if LBD_BASED_CLAUSE_DELETION
-                Clause& clause = ca[cr];
-                clause.activity() = lbd(clause);
-#else
+                ca[cr].activity() = learnt_lbd;
+#endif
+#if TIERED_CLAUSE_DB
+                num_tier[tier_Local]++;
+                setTier(ca[cr], tierOf(learnt_lbd));
+#elif ! LBD_BASED_CLAUSE_DELETION
                 claBumpActivity(ca[cr]);
 #endif
-                uncheckedEnqueue(learnt_clause[0], cr);
+                uncheckedEnqueue(learnt_clause[0], backtrack_level, cr);
             }
 
 #if BRANCHING_HEURISTIC == VSIDS
@@ -973,10 +1658,21 @@ bool Solver::simplify()
 
         }else{
             // NO CONFLICT
-            if (nof_conflicts >= 0 && conflictC >= nof_conflicts || !withinBudget()){
+            if (restartDue(conflictC) || !withinBudget()){
                 // Reached bound on number of conflicts:
                 progress_estimate = progressEstimate();
-                cancelUntil(0);
+                updatePhases(trail.size());
+                target_assigned = 0;
+                int level = 0;
+                if (reuse_trail && withinBudget()){
+                    level = reuseTrailLevel();
+                    reused_levels += level; }
+                cancelUntil(level);
+                if (rephaseDue()) rephaseNext();
+                // A due vivification pass runs at the first restart that goes back to the root level:
+                if (decisionLevel() == 0 && withinBudget() && vivifyDue() && !vivifyLearnts()){
+                    ret_search_val = l_False;
+                    return; }
                // return l_Undef;
                ret_search_val = l_Undef;
                 return;  //very important to make it return back to solve_() method
@@ -990,7 +1686,11 @@ bool Solver::simplify()
                 return;
             }
 
+#if TIERED_CLAUSE_DB
+            if (num_tier[tier_Local] >= max_learnts) {
+#else
             if (learnts.size()+shareds.size()-nAssigns() >= max_learnts) {
+#endif
                 // Reduce the set of learnt clauses:
                 reduceDB();
 #if RAPID_DELETION
@@ -1035,11 +1735,28 @@ bool Solver::simplify()
 #endif
             uncheckedEnqueue(next);
         }
+#if ALLOC_COUNT
+        checkSearchAllocs(allocs, frees);
+#endif
         source();
     }
 }
 
 
+#if ALLOC_COUNT
+// What an iteration of the search loop allocates must be kept: once they are warmed up, the only
+// allocations left are the watch lists, the clause lists and the clause arena growing beyond their
+// largest size so far (which 'vec' does by doubling), and the new arena of a copying collection.
+// Anything else freed again is a temporary:
+void Solver::checkSearchAllocs(uint64_t allocs, uint64_t frees)
+{
+    search_allocs += allocCount() - allocs;
+    if (freeCount() - gc_frees != frees)
+        fprintf(stderr, "ERROR! %" PRIu64 " temporary allocations in an iteration of the search loop.\n", freeCount() - gc_frees - frees), abort();
+}
+#endif
+
+
 double Solver::progressEstimate() const
 {
     double  progress = 0;
@@ -1082,6 +1799,57 @@ static double luby(double y, int x){
     return pow(y, seq);
 }
 
+/*_________________________________________________________________________________________________
+|
+|  walkSearch : (source)  ->  [lbool]
+|
+|  Description:
+|    Looks for a model by local search over the problem clauses (see 'Walker'), keeping the root
+|    level assignment and the assumptions. The walk starts from the saved phases, and again from the
+|    phases given to 'importPhases()' whenever there are new ones.
+|
+|  Output:
+|    'l_True' with the model in 'model' if one was found. 'l_False' only if the root level is already
+|    conflicting. Otherwise 'l_Undef', once the budget is used up.
+|________________________________________________________________________________________________@*/
+lbool Solver::walkSearch(boost::coroutines2::coroutine<void>::pull_type & source)
+{
+    assert(decisionLevel() == 0);
+    if (propagate() != CRef_Undef) return l_False;
+
+    assigns.copyTo(walk_fixed);
+    for (int i = 0; i < assumptions.size(); i++){
+        Lit p = assumptions[i];
+        if (walk_fixed[var(p)] == l_Undef)
+            walk_fixed[var(p)] = lbool(!sign(p));
+        else if (walk_fixed[var(p)] != lbool(!sign(p)))
+            return l_Undef;     // (left to the CDCL instances)
+    }
+
+    walker.seed = (uint64_t)random_seed | 1;
+    walker.build(ca, clauses, walk_fixed);
+    walker.restart(walk_pending ? walk_phases : polarity);
+    walk_pending = false;
+
+    while (withinBudget()){
+        iterations++;
+        sharedClauseIn.clear();   // (learnt clauses are of no use to the walk)
+        if (walk_pending){
+            walker.restart(walk_phases);
+            walk_pending = false; }
+
+        if (walker.walk(walk_flips)){
+            model.growTo(nVars());
+            for (Var v = 0; v < nVars(); v++)
+                model[v] = walk_fixed[v] != l_Undef ? walk_fixed[v] : walker.value(v);
+            return l_True;
+        }
+        source();
+    }
+    return l_Undef;
+}
+
+
 // NOTE: assumptions passed in member-variable 'assumptions'.
 /*lbool*/void  Solver::solve_(boost::coroutines2::coroutine<void>::pull_type & source)
 {
@@ -1107,29 +1875,52 @@ static double luby(double y, int x){
         printf("Rapid Deletion : %d\n", RAPID_DELETION);
         printf("Almost Conflict : %d\n", ALMOST_CONFLICT);
         printf("Anti Exploration : %d\n", ANTI_EXPLORATION);
+        printf("Restarts : %d\n", restart_mode);
+        printf("VMTF : %d\n", vmtf);
+        printf("Local search : %d\n", walk);
+        printf("Clause scans : %s\n", simdScanName());
         printf("============================[ Search Statistics ]==============================\n");
         printf("| Conflicts |          ORIGINAL         |          LEARNT          | Progress |\n");
         printf("|           |    Vars  Clauses Literals |    Limit  Clauses Lit/Cl |          |\n");
         printf("===============================================================================\n");
     }
 
+    lbd_fast .alpha = lbd_ema_fast;
+    lbd_slow .alpha = lbd_ema_slow;
+    trail_avg.alpha = 1.0 / 5000;
+    stable          = false;
+    mode_length     = mode_first;
+    next_switch     = conflicts + (uint64_t)mode_length;
+    next_vivify     = conflicts + vivify_int;
+    next_rephase    = conflicts + rephase_int;
+    vivify_props    = propagations;
+
     // Search:
     int curr_restarts = 0;
-    while (status == l_Undef){
+    if (walk)
+        status = walkSearch(source);
+    else while (status == l_Undef){
         double rest_base = luby_restart ? luby(restart_inc, curr_restarts) : pow(restart_inc, curr_restarts);
         nof_conflicts = rest_base * restart_first;
 //        status = search(/*rest_base * restart_first*/source);
         search(source);
         status = ret_search_val; //return value of search() method
         if (!withinBudget()) break;
-        curr_restarts++;
+        if (restart_mode == 2 && conflicts >= next_switch){
+            // Switch between stable and focused phases, each one longer than the last:
+            stable       = !stable;
+            mode_length *= mode_inc;
+            next_switch  = conflicts + (uint64_t)mode_length;
+            mode_switches++;
+        }else if (!focused())
+            curr_restarts++;
     }
 
     if (verbosity >= 1)
         printf("===============================================================================\n");
 
 
-    if (status == l_True){
+    if (status == l_True && !walk){
         // Extend & copy model:
         model.growTo(nVars());
         for (int i = 0; i < nVars(); i++) model[i] = value(i);
@@ -1137,31 +1928,23 @@ static double luby(double y, int x){
         ok = false;
 
     cancelUntil(0);
-    for(int j = 0; j < learnts.size(); ++j) {
-//        removeClause(learnts[j]);
-        CRef cr = learnts[j];
-        Clause & c = ca[cr];
-        std::string clstr = c.toString();
-        clstr.append(std::to_string((conflicts - c.getBirth())) + " " + std::to_string(c.getUSe()) + " " + std::to_string(c.getLbd()));//        clstr.append(" ");
-//        clstr.append(std::to_string(c.getUSe()));
-        lfile << clstr <<"\n";
-
-    }
-    for(int j = 0; j < shareds.size(); ++j) {
-//        removeClause(shareds[j]);
-        CRef cr = shareds[j];
-        Clause & c = ca[cr];
-        std::string clstr = c.toString();
-        clstr.append(std::to_string((conflicts - c.getBirth())) + " " + std::to_string(c.getUSe()) + " " + std::to_string(c.getLbd()));
-//        clstr.append(" ");
-//        clstr.append(std::to_string(c.getUSe()));
-        sfile << clstr <<"\n";
-//        std::cout <<"learnt clause in " << lbd(c)<<" "<< <<"\n";
-    }
+#if CLAUSE_LOG
+    // The clauses still in the database are logged with their age so far:
+    for (int j = 0; lfile.isOpen() && j < learnts.size(); j++) logClause(lfile, ca[learnts[j]], log_Alive);
+    for (int j = 0; sfile.isOpen() && j < shareds.size(); j++) logClause(sfile, ca[shareds[j]], log_Alive);
+#endif
 //    return status;
     ret_solve__val = status;
 }
 
+lbool Solver::solve_()
+{
+    boost::coroutines2::coroutine<void>::push_type sink(
+        [this](boost::coroutines2::coroutine<void>::pull_type& source){ solve_(source); });
+    while (sink());
+    return ret_solve__val;
+}
+
 //=================================================================================================
 // Writing CNF to DIMACS:
 // 
@@ -1249,6 +2032,7 @@ void Solver::relocAll(ClauseAllocator& to)
     //
     // for (int i = 0; i < watches.size(); i++)
     watches.cleanAll();
+    watches_bin.cleanAll();
     for (int v = 0; v < nVars(); v++)
         for (int s = 0; s < 2; s++){
             Lit p = mkLit(v, s);
@@ -1256,6 +2040,9 @@ void Solver::relocAll(ClauseAllocator& to)
             vec<Watcher>& ws = watches[p];
             for (int j = 0; j < ws.size(); j++)
                 ca.reloc(ws[j].cref, to);
+            vec<Watcher>& wbin = watches_bin[p];
+            for (int j = 0; j < wbin.size(); j++)
+                ca.reloc(wbin[j].cref, to);
         }
 
     // All reasons:
@@ -1284,17 +2071,208 @@ void Solver::relocAll(ClauseAllocator& to)
 }
 
 
+void Solver::compactGarbage()
+{
+    uint64_t before = ca.size();
+    ca.beginCompaction();
+    relocAll(ca);
+    ca.forwardCompaction();
+    relocAll(ca);
+    ca.endCompaction();
+    if (verbosity >= 2)
+        printf("|  Garbage compaction:   %12" PRIu64" bytes => %12" PRIu64" bytes             |\n", 
+               before*ClauseAllocator::Unit_Size, (uint64_t)ca.size()*ClauseAllocator::Unit_Size);
+}
+
+
+void Solver::notePause(double start)
+{
+    double pause = threadTime() - start;
+    gc_pauses++;
+    if (pause > gc_max_pause) gc_max_pause = pause;
+}
+
+
 void Solver::garbageCollect()
 {
-    // Initialize the next region to a size corresponding to the estimated utilization degree. This
-    // is not precise but should avoid some unnecessary reallocations for the new region:
-    ClauseAllocator to(ca.size() - ca.wasted()); 
+    double start = threadTime();
+    if (gc_step > 0){
+        // (a collection that is still in progress goes on step by step)
+        if (!gc_active){
+            beginGarbageSteps();
+            notePause(start); }
+        return; }
 
-    relocAll(to);
-    if (verbosity >= 2)
-        printf("|  Garbage collection:   %12d bytes => %12d bytes             |\n", 
-               ca.size()*ClauseAllocator::Unit_Size, to.size()*ClauseAllocator::Unit_Size);
-    to.moveTo(ca);
+    gc_collections++;
+    if (compact_gc || ca.mapped())
+        compactGarbage();
+    else{
+        // Initialize the next region to a size corresponding to the estimated utilization degree. This
+        // is not precise but should avoid some unnecessary reallocations for the new region:
+        ClauseAllocator to(ca.size() - ca.wasted()); 
+
+        relocAll(to);
+        if (verbosity >= 2)
+            printf("|  Garbage collection:   %12" PRIu64" bytes => %12" PRIu64" bytes             |\n", 
+                   (uint64_t)ca.size()*ClauseAllocator::Unit_Size, (uint64_t)to.size()*ClauseAllocator::Unit_Size);
+        to.moveTo(ca);
+    }
+    notePause(start);
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  Incremental garbage collection:
+|  
+|  Description:
+|    Slides the live clauses down in address order, like 'compactGarbage()', but 'gc_step' words of
+|    them per call of 'garbageStep()' (one call per search iteration), so that no single pause has
+|    to relocate the whole arena. Below 'gc_top' the arena is compacted; the live clauses above it
+|    are exactly those in 'clauses', 'learnts' and 'shareds' (clauses learnt in the meantime are
+|    allocated at the end), which are marked in a bit map and moved in rounds until none is left.
+|    If clauses arrive faster than the steps move them, the rounds would never end: after
+|    'gc_max_rounds' rounds, or once a round has no fewer words to go through than the one before
+|    (and more than a step), the rest is done at once by 'compactGarbage()' (counted in 'gc_forced').
+|    A moved clause is found through its watchers (on its first two literals), its reason (its
+|    first literal, or either one of a binary clause) and the clause lists. Needs all references
+|    to clauses to be in those places between steps, which does not hold for the occurrence lists
+|    of 'SimpSolver', so collections are only incremental once simplification is turned off.
+|________________________________________________________________________________________________@*/
+void Solver::beginGarbageSteps()
+{
+    gc_collections++;
+    gc_active = true;
+    gc_top    = 0;
+    gc_next   = gc_end = 0;
+    gc_wasted = 0;
+    gc_rounds = 0;
+    gc_span   = 0;
+}
+
+
+bool Solver::planGarbageSteps()
+{
+    gc_next = gc_top;
+    gc_end  = ca.size();
+    gc_span = gc_end - gc_top;
+    gc_rounds++;
+    gc_live.growTo((gc_end + 63) / 64, 0);
+    for (uint64_t i = gc_top / 64; i < (uint64_t)gc_live.size(); i++)
+        gc_live[i] = 0;
+
+    bool         any     = false;
+    vec<CRef>*   lists[] = { &clauses, &learnts, &shareds };
+    for (int l = 0; l < 3; l++)
+        for (int i = 0; i < lists[l]->size(); i++){
+            CRef cr = (*lists[l])[i];
+            if (cr >= gc_top){
+                gc_live[cr / 64] |= (uint64_t)1 << (cr % 64);
+                any = true; } }
+    return any;
+}
+
+
+void Solver::garbageStep()
+{
+    double start = threadTime();
+
+    // No watcher may point to a freed clause once its memory is reused or truncated away (as this may
+    // take long after a reduction of the learnt clauses, it is spread over steps too):
+    int64_t budget = gc_step;
+    if (!watches.cleanSome(budget) || !watches_bin.cleanSome(budget)){
+        notePause(start);
+        return; }
+
+    if (gc_next >= gc_end){
+        uint64_t backlog = ca.size() - gc_top;
+        bool     stalled = gc_rounds > 0
+                        && (gc_rounds >= gc_max_rounds || (backlog >= gc_span && backlog > (uint64_t)gc_step));
+        if (!planGarbageSteps()){
+            // Nothing is left above 'gc_top':
+            if (verbosity >= 2)
+                printf("|  Garbage steps:        %12" PRIu64" bytes => %12" PRIu64" bytes             |\n", 
+                       (uint64_t)ca.size()*ClauseAllocator::Unit_Size, (uint64_t)gc_top*ClauseAllocator::Unit_Size);
+            ca.truncate(gc_top, gc_wasted);
+            gc_live.clear();
+            gc_active = false;
+            notePause(start);
+            return; }
+        if (stalled){
+            // The rounds do not converge. Everything below 'gc_top' is compacted and every reference
+            // is up to date, so a full compaction can take over from here:
+            gc_live.clear();
+            gc_active = false;
+            gc_forced++;
+#if ALLOC_COUNT
+            uint64_t frees = freeCount();
+            compactGarbage();
+            gc_frees += freeCount() - frees;
+#else
+            compactGarbage();
+#endif
+            notePause(start);
+            return; }
+    }
+
+    gc_from.clear();
+    gc_to.clear();
+    while (budget > 0 && gc_next < gc_end){
+        uint64_t bits = gc_live[gc_next / 64] & (~(uint64_t)0 << (gc_next % 64));
+        budget--;
+        if (bits == 0){
+            gc_next = (gc_next / 64 + 1) * 64;
+            continue; }
+        CRef cr = gc_next / 64 * 64 + __builtin_ctzll(bits);
+        if (cr >= gc_end){
+            gc_next = gc_end;
+            break; }
+        gc_next = cr + 1;
+        if (ca[cr].mark() == 1) continue;   // (freed since it was marked)
+
+        int words = ca.clauseWords(cr);
+        if (gc_top != cr){
+            memmove(ca.lea(gc_top), ca.lea(cr), words * sizeof(uint32_t));
+            gc_from.push(cr);
+            gc_to  .push(gc_top); }
+        gc_top += words;
+        budget -= words;
+    }
+
+    if (gc_from.size() > 0){
+        // Update the references to the moved clauses:
+        gc_lit_stamp.growTo(4 * nVars(), 0);
+        gc_stamp++;
+        for (int i = 0; i < gc_to.size(); i++){
+            Clause& c   = ca[gc_to[i]];
+            bool    bin = c.size() == 2;
+            for (int k = 0; k < (bin ? 2 : 1); k++)
+                if (reason(var(c[k])) == gc_from[i])
+                    vardata[var(c[k])].reason = gc_to[i];
+            for (int k = 0; k < 2; k++){
+                Lit p = ~c[k];
+                if (gc_lit_stamp[2 * toInt(p) + bin] == gc_stamp) continue;
+                gc_lit_stamp[2 * toInt(p) + bin] = gc_stamp;
+                vec<Watcher>& ws = bin ? watches_bin[p] : watches[p];
+                for (int j = 0; j < ws.size(); j++)
+                    if (ws[j].cref >= gc_from[0] && ws[j].cref <= gc_from.last())
+                        ws[j].cref = gc_to[forwardIndex(ws[j].cref)];
+            }
+        }
+        redirect(clauses);
+        redirect(learnts);
+        redirect(shareds);
+    }
+    notePause(start);
+}
+
+
+void Solver::redirect(vec<CRef>& cs)
+{
+    CRef lo = gc_from[0], hi = gc_from.last();
+    for (int i = 0; i < cs.size(); i++)
+        if (cs[i] >= lo && cs[i] <= hi)
+            cs[i] = gc_to[forwardIndex(cs[i])];
 }
 
 //shared clause
@@ -1302,4 +2280,33 @@ void Solver::garbageCollect()
 void Solver::shareTo(Solver &S)
 {
     sharedClauseOut.copyTo(S.sharedClauseIn);
-}
\ No newline at end of file
+}
+
+//=================================================================================================
+// Phase exchange:
+
+
+bool Solver::exportPhases(vec<char>& phases)
+{
+    if (!walk){
+        polarity.copyTo(phases);
+        return true; }
+    if (!walker.built()) return false;
+    walker.bestPhases(phases);
+    return true;
+}
+
+
+void Solver::importPhases(const vec<char>& phases)
+{
+    if (walk){
+        phases.copyTo(walk_phases);
+        walk_pending = true;
+    }else if (rephase.find('W') != std::string::npos){
+        phases.copyTo(walk_phases);
+        walk_pending = true;
+    }else
+        for (Var v = 0; v < nVars(); v++)
+            polarity[v] = phases[v];
+    phase_imports++;
+}
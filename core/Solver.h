@@ -23,12 +23,14 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include <string>
 #include <boost/coroutine2/all.hpp>
-#include <fstream>
 #include "../mtl/Vec.h"
 #include "../mtl/Heap.h"
 #include "../mtl/Alg.h"
 #include "../utils/Options.h"
+#include "../utils/System.h"
+#include "../utils/ClauseLog.h"
 #include "../core/SolverTypes.h"
+#include "../core/Walker.h"
 namespace Minisat {
 
 //=================================================================================================
@@ -64,7 +66,7 @@ public:
     bool    simplify     ();                        // Removes already satisfied clauses.
     bool    solve        (const vec<Lit>& assumps); // Search for a model that respects a given set of assumptions.
     lbool   solveLimited (const vec<Lit>& assumps); // Search for a model that respects a given set of assumptions (With resource constraints).
-    void   solveLimited (boost::coroutines2::coroutine<void>::pull_type & source);
+    void    solveLimited (const vec<Lit>& assumps, boost::coroutines2::coroutine<void>::pull_type & source); // (as a coroutine, yields once per search iteration)
     bool    solve        ();                        // Search without assumptions.
     bool    solve        (Lit p);                   // Search for a model that respects a single assumption.
     bool    solve        (Lit p, Lit q);            // Search for a model that respects two assumptions.
@@ -86,6 +88,11 @@ public:
     void    setPolarity    (Var v, bool b); // Declare which polarity the decision heuristic should use for a variable. Requires mode 'polarity_user'.
     void    setDecisionVar (Var v, bool b); // Declare if a variable should be eligible for selection in the decision heuristic.
 
+    // Phase exchange (between CDCL and local search instances):
+    //
+    bool    exportPhases   (vec<char>& phases); // The saved phases, or the best assignment of the walk (FALSE if there is none yet).
+    void    importPhases   (const vec<char>& phases); // Take over these phases, or start the next walk from them.
+
     // Read state:
     //
     lbool   value      (Var x) const;       // The current value of a variable.
@@ -96,8 +103,10 @@ public:
     int     nClauses   ()      const;       // The current number of original clauses.
     int     nLearnts   ()      const;       // The current number of learnt clauses.
     int     nShareds   ()      const;       // The current number of shared clauses. (added by @lavleshm)
+    int     nTier      (int t) const;       // The current number of learnt and shared clauses in tier 't'.
     int     nVars      ()      const;       // The current number of variables.
     int     nFreeVars  ()      const;
+    const Walker& localSearch() const;      // The local search of 'walk' mode (with its statistics).
 
     // Resource contraints:
     //
@@ -112,6 +121,8 @@ public:
     virtual void garbageCollect();
     void    checkGarbage(double gf);
     void    checkGarbage();
+    uint64_t clauseBytes() const;       // Size of the clause arena in bytes (including wasted space).
+    uint64_t arenaReserve() const;      // Address space reserved for the clause arena in bytes (0 if not mapped).
 
     // Extra results: (read-only member variable)
     //
@@ -137,13 +148,43 @@ public:
     double    random_seed;
     bool      luby_restart;
     int       ccmin_mode;         // Controls conflict clause minimization (0=none, 1=basic, 2=deep).
+    int       bin_min_lbd;        // Minimize learnt clauses up to this LBD with the binary clauses of the asserting literal (0=never).
+    int       bin_min_size;       // ... and up to this size.
+    bool      shrink;             // Replace the literals of each level of a learnt clause by a single one where possible (all-UIP).
     int       phase_saving;       // Controls the level of phase saving (0=none, 1=limited, 2=full).
     bool      rnd_pol;            // Use random polarities for branching heuristics.
     bool      rnd_init_act;       // Initialize variable activities with a small random value.
+    bool      vmtf;               // Decide with the variable-move-to-front queue instead of the activity heap.
     double    garbage_frac;       // The fraction of wasted memory allowed before a garbage collection is triggered.
 
     int       restart_first;      // The initial restart limit.                                                                (default 100)
     double    restart_inc;        // The factor with which the restart limit is multiplied in each restart.                    (default 1.5)
+    int       restart_mode;       // Restart policy (0=Luby/geometric, 1=LBD averages, 2=alternate stable and focused phases). (default 0)
+    double    lbd_ema_fast;       // Smoothing factor of the fast moving average of learnt clause LBDs.                       (default 1/32)
+    double    lbd_ema_slow;       // Smoothing factor of the slow moving average of learnt clause LBDs.                       (default 1e-4)
+    double    restart_margin;     // Restart when the fast LBD average times this factor exceeds the slow one.                (default 0.8)
+    double    restart_block;      // Block a restart while the trail is larger than its average times this factor.            (default 1.4)
+    int       restart_min;        // The minimal number of conflicts between two LBD based restarts.                          (default 50)
+    int       mode_first;         // Conflicts of the first focused phase of restart policy 2.                                (default 1000)
+    double    mode_inc;           // The factor with which the phase length is multiplied at each stable/focused switch.      (default 2)
+    int       chrono;             // Backtrack chronologically when a conflict would jump more levels than this (-1=never).   (default -1)
+    int       confl_to_chrono;    // The number of conflicts before chronological backtracking is allowed.                   (default 4000)
+    bool      reuse_trail;        // Keep the decision levels on restarts that the next decisions would repeat.              (default false)
+    bool      vivify;             // Strengthen kept learnt and shared clauses by probing at restarts.                        (default true)
+    int       vivify_int;         // The minimal number of conflicts between two vivification passes.                          (default 5000)
+    double    vivify_eff;         // Propagations of a pass as a fraction of those spent in search since the last one.        (default 0.1)
+    int       prefetch_dist;      // Prefetch the clauses of the watchers this many entries ahead in 'propagate()' (0=off).    (default 2)
+    bool      compact_gc;         // Compact the clause arena in place on garbage collection (always done for a mapped arena). (default false)
+    int       gc_step;            // Words of clauses moved per step of an incremental garbage collection (0=stop the world). (default 0)
+    bool      walk;               // Search for a model by local search instead of CDCL (cannot prove unsatisfiability).      (default false)
+    int       walk_flips;         // Flips of local search per search iteration.                                              (default 100)
+    int       target;             // Decide with the target phases (0=never, 1=in stable phases of restart policy 2, 2=always). (default 1)
+    std::string rephase;          // Rephasing schedule, cycled over: (O)riginal, (I)nverted, (B)est, (R)andom, (W)alk phases.  (default "")
+    int       rephase_int;        // Conflicts before the first rephasing; the n-th interval is n times as long.               (default 1000)
+#if TIERED_CLAUSE_DB
+    int       core_lbd;           // Learnt and shared clauses up to this LBD are kept forever.                               (default 2)
+    int       tier2_lbd;          // Clauses up to this LBD are kept as long as they are used between two reductions.         (default 4)
+#endif
     double    learntsize_factor;  // The intitial limit for learnt clauses is a factor of the original clauses.                (default 1 / 3)
     double    learntsize_inc;     // The limit for learnt clauses is multiplied with this factor each restart.                 (default 1.1)
 
@@ -154,6 +195,19 @@ public:
     //
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts;
     uint64_t dec_vars, clauses_literals, learnts_literals, max_literals, tot_literals, shared_literals;
+    uint64_t bin_implied, long_implied; // Literals implied by binary and by longer clauses in 'propagate()'.
+    uint64_t blocked_restarts, mode_switches;
+    uint64_t chrono_backtracks, non_chrono_backtracks, reused_levels;
+    uint64_t vivify_rounds, vivified_clauses, vivified_lits;
+    uint64_t bin_min_lits, shrunk_lits; // Literals removed from learnt clauses by 'binResMinimize()' and 'shrinkLevels()'.
+    uint64_t watch_visits, watch_cycles; // Watchers of longer clauses visited in 'propagate()' and the cycles spent (PROPAGATE_CYCLES).
+    uint64_t search_allocs;              // Allocations in the iterations of 'search()', all of them growth (ALLOC_COUNT).
+    uint64_t gc_frees;                   // Deallocations by garbage collections, e.g. of the arena copied from (ALLOC_COUNT).
+    uint64_t gc_collections, gc_pauses;  // Garbage collections, and the pauses they took (one each, unless incremental).
+    uint64_t gc_forced;                  // Incremental collections that did not converge and were finished by a full compaction.
+    double   gc_max_pause;               // The longest of these pauses in seconds (CPU time).
+    uint64_t phase_imports;              // Phases taken over from other instances by 'importPhases()'.
+    uint64_t rephases;                   // Resets of the saved phases by the schedule 'rephase'.
 
     uint64_t lbd_calls;
     vec<uint64_t> lbd_seen;
@@ -191,15 +245,23 @@ public:
     int64_t num_shared;
     std::string sFileName;
     std::string lFileName;
-    std::ofstream lfile, sfile;
+#if CLAUSE_LOG
+    ClauseLog lfile, sfile;
+#endif
     /*----------------------------------------------------------------*/
 protected:
 
     // Helper structures:
     //
+    // NOTE: with 64-bit clause references (CREF64), 'VarData' and 'Watcher' are packed to 4-byte
+    // alignment, so that they take 12 bytes instead of 16.
+#pragma pack(push, 4)
     struct VarData { CRef reason; int level; };
     static inline VarData mkVarData(CRef cr, int l){ VarData d = {cr, l}; return d; }
 
+    // NOTE: binary clauses are watched in 'watches_bin', where the blocker is the other literal, so
+    // 'propagate()' never needs to look at the clause itself. Binary reasons are therefore not
+    // normalized: the implied literal of a binary reason clause may be in either position.
     struct Watcher {
         CRef cref;
         Lit  blocker;
@@ -207,6 +269,7 @@ protected:
         bool operator==(const Watcher& w) const { return cref == w.cref; }
         bool operator!=(const Watcher& w) const { return cref != w.cref; }
     };
+#pragma pack(pop)
 
     struct WatcherDeleted
     {
@@ -215,10 +278,30 @@ protected:
         bool operator()(const Watcher& w) const { return ca[w.cref].mark() == 1; }
     };
 
+    // Exponential moving average. Early on, the plain average is used instead, so that the first values
+    // are not dominated by the initial zero.
+    struct EMA {
+        double   value;
+        double   alpha;
+        uint64_t n;
+        EMA() : value(0), alpha(1), n(0) {}
+        void update(double x) { n++; value += (1.0 / n > alpha ? 1.0 / n : alpha) * (x - value); }
+    };
+
     struct VarOrderLt {
-        const vec<double>&  activity;
-        bool operator () (Var x, Var y) const { return activity[x] > activity[y]; }
-        VarOrderLt(const vec<double>&  act) : activity(act) { }
+        bool operator () (double x, double y) const { return x > y; }  // (on activities)
+    };
+
+    struct LevelGt {
+        const vec<VarData>& vardata;
+        bool operator () (Lit x, Lit y) const { return vardata[var(x)].level > vardata[var(y)].level; }
+        LevelGt(const vec<VarData>& vd) : vardata(vd) { }
+    };
+
+    struct StampLt {
+        const vec<uint64_t>& stamp;
+        bool operator () (Var x, Var y) const { return stamp[x] < stamp[y]; }
+        StampLt(const vec<uint64_t>& st) : stamp(st) { }
     };
 
     // Solver state:
@@ -234,6 +317,8 @@ protected:
     double              var_inc;          // Amount to bump next variable with.
     OccLists<Lit, vec<Watcher>, WatcherDeleted>
                         watches;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
+    OccLists<Lit, vec<Watcher>, WatcherDeleted>
+                        watches_bin;      // The same for binary clauses (kept apart so that they can be propagated first).
     vec<lbool>          assigns;          // The current assignments.
     vec<char>           polarity;         // The preferred polarity of each variable.
     vec<char>           decision;         // Declares if a variable is eligible for selection in the decision heuristic.
@@ -241,10 +326,19 @@ protected:
     vec<int>            trail_lim;        // Separator indices for different decision levels in 'trail'.
     vec<VarData>        vardata;          // Stores reason and level for each variable.
     int                 qhead;            // Head of queue (as index into the trail -- no more explicit propagation queue in MiniSat).
+    int                 qhead_bin;        // Head of the queue for binary clauses (always ahead of 'qhead').
     int                 simpDB_assigns;   // Number of top-level assignments since last execution of 'simplify()'.
     int64_t             simpDB_props;     // Remaining number of propagations that must be made before next execution of 'simplify()'.
     vec<Lit>            assumptions;      // Current set of assumptions provided to solve by the user.
-    Heap<VarOrderLt>    order_heap;       // A priority queue of variables ordered with respect to the variable activity.
+    KeyHeap<double, VarOrderLt>
+                        order_heap;       // A priority queue of variables ordered with respect to the variable activity.
+    vec<Var>            vmtf_prev;        // The VMTF decision queue: a doubly linked list of the variables in the order
+    vec<Var>            vmtf_next;        // in which they were last bumped, the most recent one last ('vmtf_last').
+    vec<uint64_t>       vmtf_stamp;       // Increasing along the queue.
+    Var                 vmtf_first;
+    Var                 vmtf_last;
+    Var                 vmtf_search;      // All decision variables after this one in the queue are assigned.
+    uint64_t            vmtf_stamps;      // The last stamp handed out.
     double              progress_estimate;// Set by 'search()'.
     bool                remove_satisfied; // Indicates whether possibly inefficient linear scan for satisfied clauses should be performed in 'simplify'.
 
@@ -256,8 +350,65 @@ protected:
     vec<char>           seen;
     vec<Lit>            analyze_stack;
     vec<Lit>            analyze_toclear;
+    vec<Lit>            shrink_lits;
     vec<Lit>            add_tmp;
+    vec<Lit>            cancel_kept;
+    vec<Var>            order_updates;
+    vec<Var>            vmtf_bumped;
+    vec<CRef>           reduce_local;
+    vec<Lit>            vivify_lits;
+    vec<Lit>            search_learnt;
+    vec<Var>            rebuild_vars;
+
+    // Incremental garbage collection ('gc_step' > 0). The live clauses slide down in address order, a
+    // bounded number per step, so that everything below 'gc_top' is compacted:
+    //
+    bool                gc_active;        // A collection is in progress.
+    CRef                gc_top;           // End of the compacted part of the arena.
+    CRef                gc_next;          // The next word of the arena to look for a live clause from,
+    CRef                gc_end;           // up to here.
+    vec<uint64_t>       gc_live;          // Bit map of the words that start a live clause in [gc_next, gc_end).
+    uint64_t            gc_wasted;        // Words freed below 'gc_top' during the collection.
+    int                 gc_rounds;        // Rounds planned by 'planGarbageSteps()' in the collection,
+    uint64_t            gc_span;          // and the words above 'gc_top' that the last one had to go through.
+    enum { gc_max_rounds = 8 };           // (after this many, the collection is finished by 'compactGarbage()')
+    vec<CRef>           gc_from;          // The clauses moved in the current step,
+    vec<CRef>           gc_to;            // and where to.
+    vec<uint32_t>       gc_lit_stamp;     // Step in which the watchers of a literal were last updated.
+    uint32_t            gc_stamp;
+
+    // Local search ('walk'):
+    //
+    Walker              walker;
+    vec<lbool>          walk_fixed;       // The root level assignment and the assumptions, which the walk keeps.
+    vec<char>           walk_phases;      // Phases from 'importPhases()': the next walk starts from them, or a CDCL
+    bool                walk_pending;     // instance rephases to them (if its schedule has 'W'). Cleared once used.
 
+    // Phases:
+    //
+    vec<char>           orig_phase;       // The polarity each variable was created with.
+    vec<char>           target_phase;     // The assignment of the largest conflict free trail since the last restart,
+    vec<char>           best_phase;       // and since the last rephasing.
+    int                 target_assigned;  // The size of those trails.
+    int                 best_assigned;
+    int                 rephase_count;    // Rephasings so far (the position in the schedule 'rephase').
+    uint64_t            next_rephase;     // Conflict count from which the next rephasing may happen.
+
+    // Restarts:
+    //
+    EMA                 lbd_fast;         // Moving averages of the LBD of learnt clauses,
+    EMA                 lbd_slow;
+    EMA                 trail_avg;        // and of the trail size at conflicts.
+    int                 restart_wait;     // Conflicts to go before the next LBD based restart may happen.
+    bool                stable;           // In a stable (Luby) phase of restart policy 2.
+    uint64_t            next_switch;      // Conflict count at which restart policy 2 switches phases.
+    double              mode_length;      // Length of the current phase of restart policy 2.
+    uint64_t            next_vivify;      // Conflict count from which the next vivification pass may run.
+    uint64_t            vivify_props;     // Propagations at the end of the last vivification pass.
+
+#if TIERED_CLAUSE_DB
+    int                 num_tier[3];      // Number of learnt and shared clauses per tier.
+#endif
     double              max_learnts;
     double              learntsize_adjust_confl;
     int                 learntsize_adjust_cnt;
@@ -274,12 +425,19 @@ protected:
     Lit      pickBranchLit    ();                                                      // Return the next decision variable.
     void     newDecisionLevel ();                                                      // Begins a new decision level.
     void     uncheckedEnqueue (Lit p, CRef from = CRef_Undef);                         // Enqueue a literal. Assumes value of literal is undefined.
+    void     uncheckedEnqueue (Lit p, int level, CRef from);                           // Enqueue a literal at the given (possibly lower) decision level.
     bool     enqueue          (Lit p, CRef from = CRef_Undef);                         // Test if fact 'p' contradicts current state, enqueue otherwise.
     CRef     propagate        ();                                                      // Perform unit propagation. Returns possibly conflicting clause.
     void     cancelUntil      (int level);                                             // Backtrack until a certain level.
+    int      conflictLevel    (CRef confl, bool& single);                              // Highest level of a conflict clause, moved to its first literal.
+    int      reuseTrailLevel  ();                                                      // The level a restart may keep without changing the next decisions.
+    void     cancelProbes     ();                                                      // Backtrack to the root level without heuristic bookkeeping.
     void     analyze          (CRef confl, vec<Lit>& out_learnt, int& out_btlevel);    // (bt = backtrack)
     void     analyzeFinal     (Lit p, vec<Lit>& out_conflict);                         // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
     bool     litRedundant     (Lit p, uint32_t abstract_levels);                       // (helper method for 'analyze()')
+    void     binResMinimize   (vec<Lit>& out_learnt);                                  // (helper method for 'analyze()')
+    void     shrinkLevels     (vec<Lit>& out_learnt);                                  // (helper method for 'analyze()')
+    Lit      levelUip         (int lvl, int lits);                                     // (helper method for 'shrinkLevels()')
 
     template<class V> int lbd (const V& clause) {
         lbd_calls++;
@@ -295,11 +453,31 @@ protected:
     }
     lbool    search           (int nof_conflicts);                                     // Search for a given number of conflicts.
     void    search           (/*int nof_conflicts*/boost::coroutines2::coroutine<void>::pull_type & source);
-        //    lbool    solve_           ();                                                      // Main solve method (assumptions given in 'assumptions').
-    void    solve_           (boost::coroutines2::coroutine<void>::pull_type & source);                                                      // Main solve method (assumptions given in 'assumptions').
+    lbool    solve_           ();                                                      // Runs the coroutine 'solve_()' to completion.
+    void     solve_           (boost::coroutines2::coroutine<void>::pull_type & source); // Main solve method (assumptions given in 'assumptions').
+    lbool    walkSearch       (boost::coroutines2::coroutine<void>::pull_type & source); // Local search instead of 'search()' (yields once per 'walk_flips' flips).
+#if ALLOC_COUNT
+    void     checkSearchAllocs(uint64_t allocs, uint64_t frees);                      // Aborts if an iteration of 'search()' freed memory.
+#endif
+    bool     focused          ()      const;                                           // TRUE if restarts are currently driven by the LBD averages.
+    bool     restartDue       (int conflictC) const;                                   // TRUE if 'search()' should return for a restart.
     void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
+#if TIERED_CLAUSE_DB
+    int      tierOf           (int lbd) const;                                         // The tier a clause with this LBD belongs to.
+    void     setTier          (Clause& c, int t);                                      // Move a learnt or shared clause to tier 't'.
+    void     collectLocal     (vec<CRef>& cs);                                         // (helper method for 'reduceDB()')
+#endif
     void     removeSatisfied  (vec<CRef>& cs);                                         // Shrink 'cs' to contain only non-satisfied clauses.
+    bool     vivifyDue        ()      const;                                           // TRUE if a vivification pass should run at this restart.
+    bool     vivifyLearnts    ();                                                      // Vivify learnt and shared clauses. FALSE if UNSAT was detected.
+    bool     vivifyClauses    (vec<CRef>& cs, uint64_t prop_limit);                    // (helper method for 'vivifyLearnts()')
     void     rebuildOrderHeap ();
+    void     updatePhases     (int consistent);                                        // Save the first 'consistent' trail literals as target and best phases.
+    bool     rephaseDue       ()      const;                                           // TRUE if the saved phases should be reset at this restart.
+    void     rephaseNext      ();                                                      // Reset the saved phases by the next entry of 'rephase'.
+    void     vmtfEnqueue      (Var x);                                                 // Move 'x' to the end of the VMTF queue.
+    void     vmtfBump         ();                                                      // Move the variables of 'vmtf_bumped' to the end, in queue order.
+    Var      vmtfNextVar      ();                                                      // The last unassigned decision variable of the queue (or var_Undef).
 
     // Maintaining Variable/Clause activity:
     //
@@ -319,9 +497,21 @@ protected:
     void     detachClause     (CRef cr, bool strict = false); // Detach a clause to watcher lists.
     void     removeClause     (CRef cr);               // Detach and free a clause.
     bool     locked           (const Clause& c) const; // Returns TRUE if a clause is a reason for some implication in the current state.
+    Lit      impliedBy        (const Clause& c) const; // The literal 'c' is the reason for (lit_Undef if none).
+    void     normalizeReason  (Clause& c, Var x);      // Put the literal of 'x' first in its (binary) reason clause 'c'.
+#if CLAUSE_LOG
+    void     logClause        (ClauseLog& log, const Clause& c, uint32_t flags = 0); // Append a record for 'c' to 'log', dated at the current conflict.
+#endif
     bool     satisfied        (const Clause& c) const; // Returns TRUE if a clause is satisfied in the current state.
 
     void     relocAll         (ClauseAllocator& to);
+    void     compactGarbage   ();                      // Garbage collection by sliding the clauses down in 'ca'.
+    void     beginGarbageSteps();                      // Start an incremental garbage collection.
+    bool     planGarbageSteps ();                      // Mark the live clauses above 'gc_top' (false if none).
+    void     garbageStep      ();                      // Move the next 'gc_step' words of live clauses down.
+    void     redirect         (vec<CRef>& cs);         // Update the references in 'cs' to the clauses moved by this step.
+    int      forwardIndex     (CRef cr) const;         // Position of the moved clause 'cr' in 'gc_from'.
+    void     notePause        (double start);          // Count a garbage collection pause that began at 'start'.
 
     // Misc:
     //
@@ -355,7 +545,9 @@ inline CRef Solver::reason(Var x) const { return vardata[x].reason; }
 inline int  Solver::level (Var x) const { return vardata[x].level; }
 
 inline void Solver::insertVarOrder(Var x) {
-    if (!order_heap.inHeap(x) && decision[x]) order_heap.insert(x); }
+    if (vmtf){
+        if (decision[x] && vmtf_stamp[x] > vmtf_stamp[vmtf_search]) vmtf_search = x; }
+    else if (!order_heap.inHeap(x) && decision[x]) order_heap.insert(x); }
 
 #if BRANCHING_HEURISTIC == VSIDS
 inline void Solver::varDecayActivity() { var_inc *= (1 / var_decay); }
@@ -365,7 +557,8 @@ inline void Solver::varBumpActivity(Var v, double inc) {
         // Rescale:
         for (int i = 0; i < nVars(); i++)
             activity[i] *= 1e-100;
-        var_inc *= 1e-100; }
+        var_inc *= 1e-100;
+        order_heap.reloadKeys(); }
 
     // Update order_heap with respect to new activity:
     if (order_heap.inHeap(v))
@@ -381,19 +574,53 @@ inline void Solver::claBumpActivity (Clause& c) {
             cla_inc *= 1e-20; } }
 #endif
 
+inline uint64_t Solver::clauseBytes() const { return (uint64_t)ca.size() * ClauseAllocator::Unit_Size; }
+inline uint64_t Solver::arenaReserve() const { return ca.mappedBytes(); }
+inline int      Solver::forwardIndex(CRef cr) const {
+    int lo = 0, hi = gc_from.size() - 1;
+    while (lo < hi){
+        int mid = (lo + hi) / 2;
+        if (gc_from[mid] < cr) lo = mid + 1; else hi = mid; }
+    assert(gc_from[lo] == cr);
+    return lo; }
 inline void Solver::checkGarbage(void){ return checkGarbage(garbage_frac); }
 inline void Solver::checkGarbage(double gf){
-    if (ca.wasted() > ca.size() * gf)
-        garbageCollect(); }
+    if (ca.wasted() > ca.size() * gf){
+#if ALLOC_COUNT
+        uint64_t frees = freeCount();
+        garbageCollect();
+        gc_frees += freeCount() - frees;
+#else
+        garbageCollect();
+#endif
+    } }
 
 // NOTE: enqueue does not set the ok flag! (only public methods do)
+inline void     Solver::uncheckedEnqueue(Lit p, CRef from)      { uncheckedEnqueue(p, decisionLevel(), from); }
 inline bool     Solver::enqueue         (Lit p, CRef from)      { return value(p) != l_Undef ? value(p) != l_False : (uncheckedEnqueue(p, from), true); }
 inline bool     Solver::addClause       (const vec<Lit>& ps)    { ps.copyTo(add_tmp); return addClause_(add_tmp); }
 inline bool     Solver::addEmptyClause  ()                      { add_tmp.clear(); return addClause_(add_tmp); }
 inline bool     Solver::addClause       (Lit p)                 { add_tmp.clear(); add_tmp.push(p); return addClause_(add_tmp); }
 inline bool     Solver::addClause       (Lit p, Lit q)          { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); return addClause_(add_tmp); }
 inline bool     Solver::addClause       (Lit p, Lit q, Lit r)   { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); return addClause_(add_tmp); }
-inline bool     Solver::locked          (const Clause& c) const { return value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && ca.lea(reason(var(c[0]))) == &c; }
+inline bool     Solver::locked          (const Clause& c) const { return impliedBy(c) != lit_Undef; }
+inline Lit      Solver::impliedBy       (const Clause& c) const {
+    for (int i = 0; i < (c.size() == 2 ? 2 : 1); i++)
+        if (value(c[i]) == l_True && reason(var(c[i])) != CRef_Undef && ca.lea(reason(var(c[i]))) == &c)
+            return c[i];
+    return lit_Undef; }
+inline void     Solver::normalizeReason (Clause& c, Var x)        { if (c.size() == 2 && var(c[0]) != x){ Lit t = c[0]; c[0] = c[1], c[1] = t; } }
+#if CLAUSE_LOG
+inline void     Solver::logClause       (ClauseLog& log, const Clause& c, uint32_t flags) {
+    log.write(c, c.getBirth(), conflicts, c.getUSe(), c.getLbd(), flags); }
+#endif
+inline bool     Solver::focused         ()              const { return restart_mode == 1 || (restart_mode == 2 && !stable); }
+inline bool     Solver::restartDue      (int conflictC) const {
+    if (restart_mode == 2 && conflicts >= next_switch) return true;
+    if (focused()) return restart_wait <= 0 && lbd_fast.value * restart_margin > lbd_slow.value;
+    return nof_conflicts >= 0 && conflictC >= nof_conflicts; }
+inline bool     Solver::vivifyDue       ()              const { return vivify && conflicts >= next_vivify; }
+inline bool     Solver::rephaseDue      ()              const { return rephase.size() > 0 && conflicts >= next_rephase; }
 inline void     Solver::newDecisionLevel()                      { trail_lim.push(trail.size()); }
 
 inline int      Solver::decisionLevel ()      const   { return trail_lim.size(); }
@@ -406,6 +633,13 @@ inline int      Solver::nAssigns      ()      const   { return trail.size(); }
 inline int      Solver::nClauses      ()      const   { return clauses.size(); }
 inline int      Solver::nLearnts      ()      const   { return learnts.size(); }
 inline int      Solver::nShareds      ()      const   { return shareds.size(); }
+#if TIERED_CLAUSE_DB
+inline int      Solver::nTier         (int t) const   { return num_tier[t]; }
+inline int      Solver::tierOf        (int lbd) const { return lbd <= core_lbd ? tier_Core : lbd <= tier2_lbd ? tier_Tier2 : tier_Local; }
+inline void     Solver::setTier       (Clause& c, int t) { num_tier[c.tier()]--; num_tier[t]++; c.tier(t); }
+#else
+inline int      Solver::nTier         (int t) const   { return t == tier_Local ? learnts.size() + shareds.size() : 0; }
+#endif
 inline int      Solver::nVars         ()      const   { return vardata.size(); }
 inline int      Solver::nFreeVars     ()      const   { return (int)dec_vars - (trail_lim.size() == 0 ? trail.size() : trail_lim[0]); }
 inline void     Solver::setPolarity   (Var v, bool b) { polarity[v] = b; }
@@ -430,13 +664,16 @@ inline bool     Solver::withinBudget() const {
 // FIXME: after the introduction of asynchronous interrruptions the solve-versions that return a
 // pure bool do not give a safe interface. Either interrupts must be possible to turn off here, or
 // all calls to solve must return an 'lbool'. I'm not yet sure which I prefer.
-//inline bool     Solver::solve         ()                    { budgetOff(); assumptions.clear(); return solve_() == l_True; }
-//inline bool     Solver::solve         (Lit p)               { budgetOff(); assumptions.clear(); assumptions.push(p); return solve_() == l_True; }
-//inline bool     Solver::solve         (Lit p, Lit q)        { budgetOff(); assumptions.clear(); assumptions.push(p); assumptions.push(q); return solve_() == l_True; }
-//inline bool     Solver::solve         (Lit p, Lit q, Lit r) { budgetOff(); assumptions.clear(); assumptions.push(p); assumptions.push(q); assumptions.push(r); return solve_() == l_True; }
-//inline bool     Solver::solve         (const vec<Lit>& assumps){ budgetOff(); assumps.copyTo(assumptions); return solve_() == l_True; }
-//inline lbool    Solver::solveLimited  (const vec<Lit>& assumps){ assumps.copyTo(assumptions); return solve_(); }
+inline bool     Solver::solve         ()                    { budgetOff(); assumptions.clear(); return solve_() == l_True; }
+inline bool     Solver::solve         (Lit p)               { budgetOff(); assumptions.clear(); assumptions.push(p); return solve_() == l_True; }
+inline bool     Solver::solve         (Lit p, Lit q)        { budgetOff(); assumptions.clear(); assumptions.push(p); assumptions.push(q); return solve_() == l_True; }
+inline bool     Solver::solve         (Lit p, Lit q, Lit r) { budgetOff(); assumptions.clear(); assumptions.push(p); assumptions.push(q); assumptions.push(r); return solve_() == l_True; }
+inline bool     Solver::solve         (const vec<Lit>& assumps){ budgetOff(); assumps.copyTo(assumptions); return solve_() == l_True; }
+inline lbool    Solver::solveLimited  (const vec<Lit>& assumps){ assumps.copyTo(assumptions); return solve_(); }
+inline void     Solver::solveLimited  (const vec<Lit>& assumps, boost::coroutines2::coroutine<void>::pull_type & source){
+    assumps.copyTo(assumptions); solve_(source); ret_solveLimited_val = ret_solve__val; }
 inline bool     Solver::okay          ()      const   { return ok; }
+inline const Walker& Solver::localSearch()    const   { return walker; }
 
 inline void     Solver::toDimacs     (const char* file){ vec<Lit> as; toDimacs(file, as); }
 inline void     Solver::toDimacs     (const char* file, Lit p){ vec<Lit> as; as.push(p); toDimacs(file, as); }
@@ -52,6 +52,39 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
     #error ANTI_EXPLORATION requires BRANCHING_HEURISTIC == LRB
 #endif
 
+// Keep the birth/use/LBD statistics of learnt and shared clauses (for the clause logs):
+#ifndef CLAUSE_STATS
+    #define CLAUSE_STATS true
+#endif
+
+// Write the learnt/shared clause logs (see 'utils/ClauseLog.h'). When off, nothing is recorded:
+#ifndef CLAUSE_LOG
+    #define CLAUSE_LOG true
+#endif
+#if CLAUSE_LOG && !CLAUSE_STATS
+    #error CLAUSE_LOG requires CLAUSE_STATS
+#endif
+
+// Count the cycles ('rdtsc') spent in the watch loop of 'propagate()' and the watchers visited there.
+// For measurements only (x86 only):
+#ifndef PROPAGATE_CYCLES
+    #define PROPAGATE_CYCLES false
+#endif
+
+// Use 64-bit clause references, so that the clause arena of a solver can grow beyond 16 GB. Watchers
+// and reasons are packed to 12 bytes instead of 16, but clause references cost twice the memory:
+#ifndef CREF64
+    #define CREF64 false
+#endif
+
+// Keep learnt and shared clauses in three tiers (core, tier2, local) chosen by their LBD:
+#ifndef TIERED_CLAUSE_DB
+    #define TIERED_CLAUSE_DB true
+#endif
+#if TIERED_CLAUSE_DB && !LBD_BASED_CLAUSE_DELETION
+    #error TIERED_CLAUSE_DB requires LBD_BASED_CLAUSE_DELETION
+#endif
+
 #include <assert.h>
 #include <string>
 
@@ -60,6 +93,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "../mtl/Vec.h"
 #include "../mtl/Map.h"
 #include "../mtl/Alloc.h"
+#include "../mtl/Sort.h"
 
 namespace Minisat {
 
@@ -154,39 +188,53 @@ inline lbool toLbool(int   v) { return lbool((uint8_t)v);  }
 // Clause -- a simple class for representing a clause:
 
 class Clause;
-typedef RegionAllocator<uint32_t>::Ref CRef;
+#if CREF64
+typedef RegionAllocator<uint32_t, uint64_t> ClauseRegion;
+#else
+typedef RegionAllocator<uint32_t, uint32_t> ClauseRegion;
+#endif
+typedef ClauseRegion::Ref CRef;
+
+// Tiers of the learnt clause database: core clauses are kept forever, tier2 clauses as long as they
+// are used, and local clauses compete for the remaining room.
+enum { tier_Local = 0, tier_Tier2 = 1, tier_Core = 2 };
 
 class Clause {
     struct {
         unsigned mark      : 2;
         unsigned learnt    : 1;
-        unsigned shared    : 2; //added by @lavleshm
+        unsigned shared    : 1; //added by @lavleshm
         unsigned has_extra : 1;
         unsigned reloced   : 1;
-        unsigned size      : 25;
-        u_int64_t born     : 64;
-        u_int64_t use      : 64;
-        unsigned lbd       :32; }                            header;
-    union { Lit lit; Act act; uint32_t abs; CRef rel; } data[0];
+        unsigned tier      : 2;
+        unsigned used      : 1;
+        unsigned vivified  : 1;
+        unsigned size      : 22; }                            header;
+    union { Lit lit; Act act; uint32_t abs; } data[0];   // (a relocation takes the first one or two)
+
+    // Learnt and shared clauses carry their statistics in 'stats_words' words after the literals and
+    // the extra field: the conflict count at birth (low and high word), the use count and the LBD at
+    // creation. Original clauses have none, so the header stays one word.
+    enum { stats_born_lo, stats_born_hi, stats_use, stats_lbd, stats_words };
 
-//    int64_t born, use; //added by @lavleshm
+    uint32_t*       stats()       { return (uint32_t*)&data[header.size + header.has_extra]; }
+    const uint32_t* stats() const { return (const uint32_t*)&data[header.size + header.has_extra]; }
 
     friend class ClauseAllocator;
 
     // NOTE: This constructor cannot be used directly (doesn't allocate enough memory).
     template<class V>
-    Clause(const V& ps, bool use_extra, bool learnt, int shared, u_int64_t conflicts, u_int64_t used, uint32_t lbd) {
+    Clause(const V& ps, bool use_extra, bool learnt, int shared, uint64_t conflicts, uint32_t used, uint32_t lbd) {
         header.mark      = 0;
         header.learnt    = learnt;
         header.shared    = shared; //added by @lavleshm
         header.has_extra = use_extra;
         header.reloced   = 0;
+        header.tier      = tier_Local;
+        header.used      = 0;
+        header.vivified  = 0;
         header.size      = ps.size();
-        header.born      = conflicts;
-        header.use       = used;
-        header.lbd       = lbd;
-//        born = 0;
-//        use = 0;
+
         for (int i = 0; i < ps.size(); i++) 
             data[i].lit = ps[i];
 
@@ -195,9 +243,18 @@ class Clause {
                 data[header.size].act = 0; 
             else 
                 calcAbstraction(); }
+
+        if (has_stats()){
+            uint32_t* st = stats();
+            st[stats_born_lo] = (uint32_t)conflicts;
+            st[stats_born_hi] = (uint32_t)(conflicts >> 32);
+            st[stats_use]     = used;
+            st[stats_lbd]     = lbd; }
     }
 
 public:
+    enum { max_size = (1 << 22) - 1 };                    // (the most 'header.size' can hold)
+
     void calcAbstraction() {
         assert(header.has_extra);
         uint32_t abstraction = 0;
@@ -207,22 +264,35 @@ public:
 
 
     int          size        ()      const   { return header.size; }
-    void         shrink      (int i)         { assert(i <= size()); if (header.has_extra) data[header.size-i] = data[header.size]; header.size -= i; }
+    void         shrink      (int i)         { assert(i <= size());
+                                               for (int k = 0; k < extraWords(); k++) data[header.size-i+k] = data[header.size+k];
+                                               header.size -= i; }
     void         pop         ()              { shrink(1); }
     bool         learnt      ()      const   { return header.learnt; }
     int          shared      ()      const   { return header.shared;} //added by @lavleshm
-    u_int64_t      getBirth  ()      const   { return header.born; }
-    u_int64_t    getUSe      ()      const   { return header.use; }
-    void         incUse      ()              {header.use++;}
-    unsigned     getLbd      ()      const   {return header.lbd; } //lbd when clause is created
     bool         has_extra   ()      const   { return header.has_extra; }
+    bool         has_stats   ()      const   { return CLAUSE_STATS && (header.learnt || header.shared); }
+    int          extraWords  ()      const   { return header.has_extra + (has_stats() ? stats_words : 0); } // Words after the literals.
+    uint64_t     getBirth    ()      const   { return has_stats() ? stats()[stats_born_lo] | (uint64_t)stats()[stats_born_hi] << 32 : 0; }
+    uint32_t     getUSe      ()      const   { return has_stats() ? stats()[stats_use] : 0; }
+    void         incUse      ()              { if (has_stats()) stats()[stats_use]++; }
+    unsigned     getLbd      ()      const   { return has_stats() ? stats()[stats_lbd] : 0; } //lbd when clause is created
     uint32_t     mark        ()      const   { return header.mark; }
     void         mark        (uint32_t m)    { header.mark = m; }
+    int          tier        ()      const   { return header.tier; }
+    void         tier        (int t)         { header.tier = t; }
+    bool         used        ()      const   { return header.used; }
+    void         used        (bool b)        { header.used = b; }
+    bool         vivified    ()      const   { return header.vivified; }
+    void         vivified    (bool b)        { header.vivified = b; }
     const Lit&   last        ()      const   { return data[header.size-1].lit; }
 
     bool         reloced     ()      const   { return header.reloced; }
-    CRef         relocation  ()      const   { return data[0].rel; }
-    void         relocate    (CRef c)        { header.reloced = 1; data[0].rel = c; }
+    CRef         relocation  ()      const   { CRef c = data[0].abs;
+                                               if (sizeof(CRef) > sizeof(uint32_t)) c |= (uint64_t)data[1].abs << 32;
+                                               return c; }
+    void         relocate    (CRef c)        { header.reloced = 1; data[0].abs = (uint32_t)c;
+                                               if (sizeof(CRef) > sizeof(uint32_t)) data[1].abs = (uint32_t)((uint64_t)c >> 32); }
 
     // NOTE: somewhat unsafe to change the clause in-place! Must manually call 'calcAbstraction' afterwards for
     //       subsumption operations to behave correctly.
@@ -251,61 +321,146 @@ public:
 // ClauseAllocator -- a simple class for allocating memory for clauses:
 
 
-const CRef CRef_Undef = RegionAllocator<uint32_t>::Ref_Undef;
-class ClauseAllocator : public RegionAllocator<uint32_t>
+const CRef CRef_Undef = ClauseRegion::Ref_Undef;
+class ClauseAllocator : public ClauseRegion
 {
-    static int clauseWord32Size(int size, bool has_extra){
-        return (sizeof(Clause) + (sizeof(Lit) * (size + (int)has_extra))) / sizeof(uint32_t); }
+    // (With 64-bit references, a relocation needs two words after the header, even for a unit clause.)
+    static int clauseWord32Size(int size, int extra_words){
+        int words = size + extra_words;
+        if (sizeof(CRef) > sizeof(uint32_t) && words < 2) words = 2;
+        return (sizeof(Clause) + (sizeof(Lit) * words)) / sizeof(uint32_t); }
+
+    // In-place compaction (see 'beginCompaction()'):
+    enum { compact_Off, compact_Mark, compact_Forward };
+    enum { reloc_words = sizeof(CRef) / sizeof(uint32_t) };
+    int           compact_phase;
+    vec<CRef>     compact_live;   // The clauses reached while marking, sorted by address when forwarding.
+    vec<uint32_t> compact_saved;  // The words of each live clause overwritten by its relocation.
+
+    void compactReloc(CRef& cr)
+    {
+        Clause& c = operator[](cr);
+        if (compact_phase == compact_Mark){
+            if (!c.reloced()){
+                c.header.reloced = 1;
+                compact_live.push(cr); }
+        }else{
+            assert(compact_phase == compact_Forward && c.reloced());
+            cr = c.relocation(); }
+    }
+
  public:
     bool extra_clause_field;
 
-    ClauseAllocator(uint32_t start_cap) : RegionAllocator<uint32_t>(start_cap), extra_clause_field(false){}
-    ClauseAllocator() : extra_clause_field(false){}
+    ClauseAllocator(Ref start_cap) : ClauseRegion(start_cap), compact_phase(compact_Off), extra_clause_field(false){}
+    ClauseAllocator() : compact_phase(compact_Off), extra_clause_field(false){}
 
     void moveTo(ClauseAllocator& to){
         to.extra_clause_field = extra_clause_field;
-        RegionAllocator<uint32_t>::moveTo(to); }
+        ClauseRegion::moveTo(to); }
 
     template<class Lits>
-    CRef alloc(const Lits& ps, bool learnt = false, int shared = 0, int conflicts = 0, int used = 0, unsigned lbd = 500)
+    CRef alloc(const Lits& ps, bool learnt = false, int shared = 0, uint64_t conflicts = 0, uint32_t used = 0, unsigned lbd = 500)
     {
         assert(sizeof(Lit)      == sizeof(uint32_t));
         assert(sizeof(float)    == sizeof(uint32_t));
+        assert(sizeof(Clause)   == sizeof(uint32_t));
+        if (ps.size() > Clause::max_size) throw OutOfMemoryException();   // (the size would not fit the header)
         bool use_extra = learnt | (bool)shared | extra_clause_field;
+        bool use_stats = CLAUSE_STATS && (learnt || shared);
 
-        CRef cid = RegionAllocator<uint32_t>::alloc(clauseWord32Size(ps.size(), use_extra));
+        CRef cid = ClauseRegion::alloc(clauseWord32Size(ps.size(), (int)use_extra + (use_stats ? Clause::stats_words : 0)));
         new (lea(cid)) Clause(ps, use_extra, learnt, shared, conflicts, used, lbd);
 
         return cid;
     }
 
     // Deref, Load Effective Address (LEA), Inverse of LEA (AEL):
-    Clause&       operator[](Ref r)       { return (Clause&)RegionAllocator<uint32_t>::operator[](r); }
-    const Clause& operator[](Ref r) const { return (Clause&)RegionAllocator<uint32_t>::operator[](r); }
-    Clause*       lea       (Ref r)       { return (Clause*)RegionAllocator<uint32_t>::lea(r); }
-    const Clause* lea       (Ref r) const { return (Clause*)RegionAllocator<uint32_t>::lea(r); }
-    Ref           ael       (const Clause* t){ return RegionAllocator<uint32_t>::ael((uint32_t*)t); }
+    Clause&       operator[](Ref r)       { return (Clause&)ClauseRegion::operator[](r); }
+    const Clause& operator[](Ref r) const { return (Clause&)ClauseRegion::operator[](r); }
+    Clause*       lea       (Ref r)       { return (Clause*)ClauseRegion::lea(r); }
+    const Clause* lea       (Ref r) const { return (Clause*)ClauseRegion::lea(r); }
+    Ref           ael       (const Clause* t){ return ClauseRegion::ael((uint32_t*)t); }
+
+    int clauseWords(CRef cid) const { const Clause& c = operator[](cid); return clauseWord32Size(c.size(), c.extraWords()); }
 
     void free(CRef cid)
     {
         Clause& c = operator[](cid);
-        RegionAllocator<uint32_t>::free(clauseWord32Size(c.size(), c.has_extra()));
+        ClauseRegion::free(clauseWord32Size(c.size(), c.extraWords()));
     }
 
     void reloc(CRef& cr, ClauseAllocator& to)
     {
+        if (&to == this){ compactReloc(cr); return; }
+
         Clause& c = operator[](cr);
         
         if (c.reloced()) { cr = c.relocation(); return; }
         
         cr = to.alloc(c, c.learnt(), c.shared(), c.getBirth(), c.getUSe(), c.getLbd());
-        c.relocate(cr);
         
         // Copy extra data-fields: 
         // (This could be cleaned-up. Generalize Clause-constructor to be applicable here instead?)
         to[cr].mark(c.mark());
+        to[cr].tier(c.tier());
+        to[cr].used(c.used());
+        to[cr].vivified(c.vivified());
         if (to[cr].learnt() || to[cr].shared())         to[cr].activity() = c.activity();
         else if (to[cr].has_extra()) to[cr].calcAbstraction();
+
+        // (Last, as a 64-bit relocation may overwrite the field after the literal of a unit clause.)
+        c.relocate(cr);
+    }
+
+    // Sliding compaction without a second region. Every reference is passed to 'reloc(cr, *this)'
+    // twice: once after 'beginCompaction()' to find the live clauses, and once after
+    // 'forwardCompaction()' to update it. 'endCompaction()' then slides the live clauses down in
+    // address order (so none is overwritten before it has moved), keeping their relative order.
+    void beginCompaction()
+    {
+        assert(compact_phase == compact_Off);
+        compact_phase = compact_Mark;
+        compact_live.clear();
+    }
+
+    void forwardCompaction()
+    {
+        assert(compact_phase == compact_Mark);
+        compact_phase = compact_Forward;
+        sort(compact_live);
+
+        compact_saved.clear();
+        Ref top = 0;
+        for (int i = 0; i < compact_live.size(); i++){
+            Clause& c = operator[](compact_live[i]);
+            for (int k = 0; k < reloc_words; k++)
+                compact_saved.push(c.data[k].abs);
+            c.relocate(top);
+            top += clauseWord32Size(c.size(), c.extraWords()); }
+    }
+
+    void endCompaction()
+    {
+        assert(compact_phase == compact_Forward);
+        Ref top = 0;
+        for (int i = 0; i < compact_live.size(); i++){
+            Clause& c     = operator[](compact_live[i]);
+            Ref     dst   = c.relocation();
+            int     words = clauseWord32Size(c.size(), c.extraWords());
+            assert(dst == top && dst <= compact_live[i]);
+            memmove(ClauseRegion::lea(dst), ClauseRegion::lea(compact_live[i]), words * sizeof(uint32_t));
+
+            Clause& d = operator[](dst);
+            for (int k = 0; k < reloc_words; k++)
+                d.data[k].abs = compact_saved[i * reloc_words + k];
+            d.header.reloced = 0;
+            top += words; }
+
+        truncate(top);
+        compact_live .clear(true);
+        compact_saved.clear(true);
+        compact_phase = compact_Off;
     }
 };
 
@@ -330,6 +485,7 @@ class OccLists
     Vec&  lookup    (const Idx& idx){ if (dirty[toInt(idx)]) clean(idx); return occs[toInt(idx)]; }
 
     void  cleanAll  ();
+    bool  cleanSome (int64_t& budget);  // Clean until 'budget' entries are used up. True if all are clean.
     void  clean     (const Idx& idx);
     void  smudge    (const Idx& idx){
         if (dirty[toInt(idx)] == 0){
@@ -346,6 +502,19 @@ class OccLists
 };
 
 
+template<class Idx, class Vec, class Deleted>
+bool OccLists<Idx,Vec,Deleted>::cleanSome(int64_t& budget)
+{
+    while (dirties.size() > 0 && budget > 0){
+        Idx idx = dirties.last();
+        dirties.pop();
+        if (dirty[toInt(idx)]){
+            budget -= occs[toInt(idx)].size();
+            clean(idx); } }
+    return dirties.size() == 0;
+}
+
+
 template<class Idx, class Vec, class Deleted>
 void OccLists<Idx,Vec,Deleted>::cleanAll()
 {
@@ -378,7 +547,7 @@ template<class T>
 class CMap
 {
     struct CRefHash {
-        uint32_t operator()(CRef cr) const { return (uint32_t)cr; } };
+        uint32_t operator()(CRef cr) const { return (uint32_t)cr ^ (uint32_t)((uint64_t)cr >> 32); } };
 
     typedef Map<CRef, T, CRefHash> HashTable;
     HashTable map;
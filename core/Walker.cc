@@ -0,0 +1,221 @@
+/***************************************************************************************[Walker.cc]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <math.h>
+#include "../core/Walker.h"
+
+using namespace Minisat;
+
+// Break counts from here on all get the probability of the last one:
+enum { max_break = 64 };
+
+//=================================================================================================
+// Constructor:
+
+
+Walker::Walker() :
+    cb            (2.38)
+  , seed          (91648253)
+  , flips         (0)
+  , restarts      (0)
+  , nvars         (0)
+  , empty_clause  (false)
+  , best_log_full (false)
+  , best_unsat    (0)
+{}
+
+
+//=================================================================================================
+// Setting up:
+
+
+void Walker::build(const ClauseAllocator& ca, const vec<CRef>& cs, const vec<lbool>& fixed)
+{
+    nvars        = fixed.size();
+    empty_clause = false;
+    lits  .clear();
+    cstart.clear();
+
+    for (int i = 0; i < cs.size(); i++){
+        const Clause& c = ca[cs[i]];
+        if (c.mark() == 1) continue;
+        int  start = lits.size();
+        bool sat   = false;
+        for (int k = 0; k < c.size() && !sat; k++)
+            if (fixed[var(c[k])] == l_Undef)
+                lits.push(c[k]);
+            else
+                sat = (fixed[var(c[k])] ^ sign(c[k])) == l_True;
+        if (sat)
+            lits.shrink(lits.size() - start);
+        else if (lits.size() == start)
+            empty_clause = true;
+        else
+            cstart.push(start);
+    }
+    cstart.push(lits.size());
+    int nclauses = cstart.size() - 1;
+
+    // Occurrence lists, by counting first:
+    occ_start.clear();
+    occ_start.growTo(2*nvars + 1, 0);
+    for (int i = 0; i < lits.size(); i++)
+        occ_start[toInt(lits[i]) + 1]++;
+    for (int i = 1; i < occ_start.size(); i++)
+        occ_start[i] += occ_start[i-1];
+    occs.growTo(lits.size());
+    vec<int> fill;
+    occ_start.copyTo(fill);
+    for (int c = 0; c < nclauses; c++)
+        for (int k = cstart[c]; k < cstart[c+1]; k++)
+            occs[fill[toInt(lits[k])]++] = c;
+
+    num_true .growTo(nclauses);
+    crit     .growTo(nclauses);
+    unsat_pos.growTo(nclauses);
+    breaks   .growTo(nvars);
+    val      .growTo(nvars, 0);
+
+    probs.clear();
+    for (int b = 0; b <= max_break; b++)
+        probs.push(pow(1.0 + b, -cb));
+}
+
+
+void Walker::restart(const vec<char>& polarity)
+{
+    for (Var v = 0; v < nvars; v++){
+        val   [v] = !polarity[v];
+        breaks[v] = 0; }
+
+    unsat.clear();
+    for (int c = 0; c < cstart.size() - 1; c++){
+        int t = 0;
+        Var x = 0;
+        for (int k = cstart[c]; k < cstart[c+1]; k++)
+            if (val[var(lits[k])] != sign(lits[k])){
+                t++;
+                x ^= var(lits[k]); }
+        num_true[c] = t;
+        crit    [c] = x;
+        if (t == 0)
+            makeUnsat(c);
+        else if (t == 1)
+            breaks[x]++;
+    }
+
+    val.copyTo(best);
+    best_log.clear();
+    best_log_full = false;
+    best_unsat    = unsat.size();
+    restarts++;
+}
+
+
+//=================================================================================================
+// Walking:
+
+
+void Walker::flip(Var v)
+{
+    val[v] ^= 1;
+    Lit p = mkLit(v, !val[v]);  // (the literal that became true)
+
+    for (int i = occ_start[toInt(p)]; i < occ_start[toInt(p)+1]; i++){
+        int c = occs[i];
+        if (num_true[c]++ == 0){
+            makeSat(c);
+            breaks[v]++;
+        }else if (num_true[c] == 2)
+            breaks[crit[c]]--;
+        crit[c] ^= v;
+    }
+
+    for (int i = occ_start[toInt(~p)]; i < occ_start[toInt(~p)+1]; i++){
+        int c = occs[i];
+        crit[c] ^= v;
+        if (--num_true[c] == 0){
+            makeUnsat(c);
+            breaks[v]--;
+        }else if (num_true[c] == 1)
+            breaks[crit[c]]++;
+    }
+
+    flips++;
+}
+
+
+Var Walker::pick(int c)
+{
+    int    n   = cstart[c+1] - cstart[c];
+    double sum = 0;
+    pick_probs.clear();
+    for (int k = cstart[c]; k < cstart[c+1]; k++){
+        int b = breaks[var(lits[k])];
+        sum += probs[b < max_break ? b : max_break];
+        pick_probs.push(sum);
+    }
+
+    double r = drand() * sum;
+    int    k = 0;
+    while (k < n - 1 && pick_probs[k] <= r)
+        k++;
+    return var(lits[cstart[c] + k]);
+}
+
+
+void Walker::saveBest()
+{
+    if (best_log_full)
+        val.copyTo(best);
+    else
+        for (int i = 0; i < best_log.size(); i++)
+            best[best_log[i]] ^= 1;
+    best_log.clear();
+    best_log_full = false;
+    best_unsat    = unsat.size();
+}
+
+
+bool Walker::walk(int64_t steps)
+{
+    if (empty_clause) return false;
+
+    for (int64_t i = 0; i < steps && unsat.size() > 0; i++){
+        Var v = pick(unsat[(int)(drand() * unsat.size())]);
+        flip(v);
+
+        if (!best_log_full){
+            if (best_log.size() < nvars)
+                best_log.push(v);
+            else{
+                best_log.clear();
+                best_log_full = true; } }
+        if (unsat.size() < best_unsat)
+            saveBest();
+    }
+
+    return unsat.size() == 0;
+}
+
+
+void Walker::bestPhases(vec<char>& polarity)
+{
+    polarity.growTo(nvars);
+    for (Var v = 0; v < nvars; v++)
+        polarity[v] = !best[v];
+}
@@ -0,0 +1,115 @@
+/****************************************************************************************[Walker.h]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Minisat_Walker_h
+#define Minisat_Walker_h
+
+#include "../mtl/Vec.h"
+#include "../core/SolverTypes.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// Walker -- ProbSAT local search over a copy of the problem clauses:
+//
+// The clauses not satisfied by the fixed (root level) assignment are copied without their false
+// literals into one flat array, with occurrence lists per literal next to it. Each step picks a
+// random unsatisfied clause and flips one of its variables, chosen with a probability that falls
+// polynomially with its break count (the number of clauses it is the only true literal of). The
+// break counts are kept up to date on every flip: each clause stores how many of its literals are
+// true, and the xor of their variables, which is the critical variable when there is only one.
+//
+// The best assignment of the current walk (the one with the fewest unsatisfied clauses) is kept as
+// well. Instead of copying the whole assignment on every improvement, the flips since the last one
+// are logged and applied to the saved copy when the next improvement comes.
+
+class Walker {
+public:
+    Walker();
+
+    double   cb;                  // The break count exponent of the flip probabilities.
+    uint64_t seed;                // State of the random generator (must never be 0).
+
+    // Statistics: (read-only member variable)
+    //
+    uint64_t flips, restarts;
+
+    void     build     (const ClauseAllocator& ca, const vec<CRef>& cs, const vec<lbool>& fixed);
+    void     restart   (const vec<char>& polarity);   // Start a new walk from these phases (as in 'Solver::polarity').
+    bool     walk      (int64_t steps);               // Make up to 'steps' flips. TRUE if all clauses are satisfied.
+
+    bool     built     ()      const;
+    int      nUnsat    ()      const;                 // Unsatisfied clauses of the current assignment,
+    int      bestUnsat ()      const;                 // and of the best one in this walk.
+    lbool    value     (Var v) const;                 // The current value of a variable.
+    void     bestPhases(vec<char>& polarity);         // The best assignment in this walk, as phases.
+
+protected:
+    int                 nvars;
+    bool                empty_clause;     // A clause is false under the fixed assignment.
+    vec<Lit>            lits;             // The literals of all clauses, one after the other.
+    vec<int>            cstart;           // Clause 'c' is 'lits[cstart[c]]' up to 'lits[cstart[c+1]]'.
+    vec<int>            occ_start;        // The clauses of literal 'p' are 'occs[occ_start[toInt(p)]]' up to
+    vec<int>            occs;             // 'occs[occ_start[toInt(p)+1]]'.
+    vec<int>            num_true;         // The number of true literals of each clause,
+    vec<Var>            crit;             // and the xor of their variables.
+    vec<int>            unsat;            // The unsatisfied clauses,
+    vec<int>            unsat_pos;        // and their positions there.
+    vec<int>            breaks;           // The break count of each variable.
+    vec<char>           val;              // The current assignment.
+    vec<char>           best;             // The best assignment of the walk (up to the flips in 'best_log').
+    vec<Var>            best_log;         // The flips since 'best' was last brought up to date.
+    bool                best_log_full;    // Too many flips to log: 'best' is copied from 'val' instead.
+    int                 best_unsat;
+    vec<double>         probs;            // Flip probability (unnormalized) of each break count.
+
+    // Temporaries:
+    //
+    vec<double>         pick_probs;
+
+    void     flip      (Var v);
+    Var      pick      (int c);                        // Choose a variable of the unsatisfied clause 'c' to flip.
+    void     saveBest  ();
+    void     makeUnsat (int c);
+    void     makeSat   (int c);
+
+    // Returns a random double 0 <= x < 1 (xorshift64*):
+    double   drand     () {
+        seed ^= seed >> 12; seed ^= seed << 25; seed ^= seed >> 27;
+        return ((seed * 2685821657736338717ULL) >> 11) * (1.0 / 9007199254740992.0); }
+};
+
+
+//=================================================================================================
+// Implementation of inline methods:
+
+inline bool  Walker::built    ()      const { return cstart.size() > 0; }
+inline int   Walker::nUnsat   ()      const { return unsat.size(); }
+inline int   Walker::bestUnsat()      const { return best_unsat; }
+inline lbool Walker::value    (Var v) const { return lbool((bool)val[v]); }
+
+inline void Walker::makeUnsat(int c) { unsat_pos[c] = unsat.size(); unsat.push(c); }
+inline void Walker::makeSat  (int c) {
+    int last = unsat.last();
+    unsat[unsat_pos[c]] = last;
+    unsat_pos[last]     = unsat_pos[c];
+    unsat.pop(); }
+
+//=================================================================================================
+}
+
+#endif
@@ -0,0 +1,308 @@
+/*****************************************************************************************[Main.cc]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "../utils/Options.h"
+#include "../utils/ParseUtils.h"
+#include "../utils/ClauseLog.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Reading the clause logs:
+//
+// Both the binary logs and the text format (plain or gzipped) are accepted. A text line only has
+// the lifetime of its clause, so 'born' is read as 0 and the 'log_Alive' flag is never set.
+
+class LogStream {
+    ClauseLogReader bin;
+    gzFile          gz;
+    StreamBuffer*   text;
+    vec<int64_t>    nums;
+
+public:
+    LogStream() : gz(NULL), text(NULL) {}
+    ~LogStream() { delete text; if (gz != NULL) gzclose(gz); }
+
+    bool open(const char* file) {
+        if (bin.open(file)) return true;
+        gz = gzopen(file, "rb");
+        if (gz == NULL) return false;
+        text = new StreamBuffer(gz);
+        return true; }
+
+    bool next(ClauseRecord& r) {
+        if (text == NULL) return bin.next(r);
+
+        // One clause per line: literals, lifetime, uses, LBD.
+        StreamBuffer& in = *text;
+        for (;;){
+            nums.clear();
+            while (*in != EOF && *in != '\n'){
+                if (*in == ' ' || *in == '\t' || *in == '\r') { ++in; continue; }
+                bool    neg = *in == '-';
+                int64_t val = 0;
+                if (neg) ++in;
+                if (*in < '0' || *in > '9')
+                    fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", *in), exit(3);
+                while (*in >= '0' && *in <= '9')
+                    val = val*10 + (*in - '0'), ++in;
+                nums.push(neg ? -val : val);
+            }
+            if (*in == '\n') ++in;
+            if (nums.size() >= 3) break;
+            if (nums.size() > 0)
+                fprintf(stderr, "PARSE ERROR! Incomplete clause record.\n"), exit(3);
+            if (*in == EOF) return false;
+        }
+
+        int n = nums.size() - 3;
+        r.lits.clear();
+        for (int i = 0; i < n; i++) r.lits.push((int)nums[i]);
+        r.flags = 0;
+        r.born  = 0;
+        r.died  = nums[n];
+        r.uses  = nums[n+1];
+        r.lbd   = nums[n+2];
+        return true; }
+};
+
+
+//=================================================================================================
+// Conversion of the binary clause logs to text:
+//
+// One line per clause, in the format the solver used to write directly: the literals (as 'toInt()',
+// each followed by a space), then the lifetime in conflicts, the number of uses and the LBD.
+
+static void writeText(FILE* out, const ClauseRecord& r)
+{
+    for (int i = 0; i < r.lits.size(); i++)
+        fprintf(out, "%d ", r.lits[i]);
+    fprintf(out, "%" PRIu64 " %u %u\n", r.lifetime(), r.uses, r.lbd);
+}
+
+
+//=================================================================================================
+// Analysis:
+//
+// All logs are read in one pass. Every log is summarized into fixed-size histograms, and the most
+// used shared clauses are kept in a bounded heap, so memory does not grow with the size of the logs.
+
+enum { life_buckets = 40, use_buckets = 8, lbd_buckets = 31 };
+
+// Bucket 0 holds 0, bucket k > 0 holds [2^(k-1), 2^k):
+static int log2Bucket(uint64_t x, int buckets) {
+    int b = 0;
+    while (x > 0 && b < buckets-1) x >>= 1, b++;
+    return b; }
+
+static std::string bucketName(int b, int buckets) {
+    if (b == 0) return "0";
+    uint64_t lo = (uint64_t)1 << (b-1), hi = ((uint64_t)1 << b) - 1;
+    char buf[64];
+    if      (b == buckets-1) snprintf(buf, sizeof(buf), "%" PRIu64 "+", lo);
+    else if (lo == hi)       snprintf(buf, sizeof(buf), "%" PRIu64, lo);
+    else                     snprintf(buf, sizeof(buf), "%" PRIu64 "-%" PRIu64, lo, hi);
+    return buf; }
+
+struct LogSummary {
+    std::string file;
+    bool        shared;
+    int         rank;
+
+    uint64_t    clauses, used, alive;
+    double      sum_life, sum_uses, sum_lbd;
+    uint64_t    life_uses[life_buckets][use_buckets];   // Clauses per (lifetime, uses) bucket.
+    uint64_t    lbd_clauses[lbd_buckets];               // Clauses, uses and lifetime per LBD (the last bucket
+    double      lbd_uses   [lbd_buckets];               // holds all larger LBDs).
+    double      lbd_life   [lbd_buckets];
+
+    LogSummary(const std::string& f) : file(f), shared(false), rank(-1), clauses(0), used(0), alive(0), sum_life(0), sum_uses(0), sum_lbd(0) {
+        memset(life_uses, 0, sizeof(life_uses));
+        memset(lbd_clauses, 0, sizeof(lbd_clauses));
+        for (int i = 0; i < lbd_buckets; i++) lbd_uses[i] = lbd_life[i] = 0;
+
+        // Kind and rank of the instance come from the log name ('shared_<rank>.bin' etc.):
+        size_t      slash = f.find_last_of('/');
+        std::string base  = slash == std::string::npos ? f : f.substr(slash+1);
+        shared = base.compare(0, 7, "shared_") == 0;
+        if (shared || base.compare(0, 7, "learnt_") == 0)
+            rank = atoi(base.c_str() + 7);
+    }
+
+    void add(const ClauseRecord& r) {
+        uint64_t life = r.lifetime();
+        clauses++;
+        used     += r.uses > 0;
+        alive    += r.alive();
+        sum_life += life;
+        sum_uses += r.uses;
+        sum_lbd  += r.lbd;
+        life_uses[log2Bucket(life, life_buckets)][log2Bucket(r.uses, use_buckets)]++;
+        int l = std::min((int)r.lbd, lbd_buckets-1);
+        lbd_clauses[l]++;
+        lbd_uses[l] += r.uses;
+        lbd_life[l] += life; }
+
+    // Uses per 1000 conflicts of clause lifetime:
+    double useRate() const { return sum_life > 0 ? 1000 * sum_uses / sum_life : 0; }
+};
+
+struct TopClause {
+    uint32_t    uses;
+    uint32_t    lbd;
+    uint64_t    life;
+    int         rank;
+    std::vector<int> lits;
+
+    // Heap order: the least used clause (the first to be dropped) on top.
+    bool operator < (const TopClause& other) const {
+        return uses != other.uses ? uses > other.uses : life < other.life; }
+};
+
+static void printSummary(const LogSummary& s)
+{
+    printf("==============================[ %s ]\n", s.file.c_str());
+    printf("|  %s clauses of rank %d: %" PRIu64 " (%" PRIu64 " alive at the end)\n", s.shared ? "Shared" : "Learnt", s.rank, s.clauses, s.alive);
+    if (s.clauses == 0) return;
+    printf("|  Used at least once:   %5.1f %%\n", 100.0 * s.used / s.clauses);
+    printf("|  Mean lifetime:        %12.1f conflicts\n", s.sum_life / s.clauses);
+    printf("|  Mean uses:            %12.2f (%.3f per 1000 conflicts alive)\n", s.sum_uses / s.clauses, s.useRate());
+    printf("|  Mean LBD:             %12.2f\n", s.sum_lbd / s.clauses);
+
+    printf("|\n|  Clauses by lifetime (rows) and uses (columns):\n|  %15s", "");
+    for (int u = 0; u < use_buckets; u++) printf(" %9s", bucketName(u, use_buckets).c_str());
+    printf("\n");
+    for (int l = 0; l < life_buckets; l++){
+        uint64_t row = 0;
+        for (int u = 0; u < use_buckets; u++) row += s.life_uses[l][u];
+        if (row == 0) continue;
+        printf("|  %15s", bucketName(l, life_buckets).c_str());
+        for (int u = 0; u < use_buckets; u++) printf(" %9" PRIu64, s.life_uses[l][u]);
+        printf("\n");
+    }
+
+    printf("|\n|  %5s %10s %10s %14s\n", "LBD", "clauses", "mean uses", "mean lifetime");
+    for (int l = 0; l < lbd_buckets; l++)
+        if (s.lbd_clauses[l] > 0)
+            printf("|  %4d%s %10" PRIu64 " %10.2f %14.1f\n", l, l == lbd_buckets-1 ? "+" : " ", s.lbd_clauses[l],
+                   s.lbd_uses[l] / s.lbd_clauses[l], s.lbd_life[l] / s.lbd_clauses[l]);
+}
+
+static void printComparison(const std::vector<LogSummary>& logs)
+{
+    printf("===========================[ Learnt vs. shared ]===============================\n");
+    printf("|  %4s %-7s %10s %7s %10s %12s %9s\n", "rank", "kind", "clauses", "used%", "mean uses", "uses/1000c", "mean LBD");
+    std::vector<const LogSummary*> order;
+    for (size_t i = 0; i < logs.size(); i++) order.push_back(&logs[i]);
+    std::stable_sort(order.begin(), order.end(), [](const LogSummary* a, const LogSummary* b){
+        return a->rank != b->rank ? a->rank < b->rank : a->shared < b->shared; });
+    for (size_t i = 0; i < order.size(); i++){
+        const LogSummary& s = *order[i];
+        double n = s.clauses > 0 ? (double)s.clauses : 1;
+        printf("|  %4d %-7s %10" PRIu64 " %7.1f %10.2f %12.3f %9.2f\n", s.rank, s.shared ? "shared" : "learnt",
+               s.clauses, 100 * s.used / n, s.sum_uses / n, s.useRate(), s.sum_lbd / n);
+    }
+}
+
+static void printTop(std::vector<TopClause>& top)
+{
+    std::sort_heap(top.begin(), top.end());
+    printf("========================[ Most used shared clauses ]===========================\n");
+    printf("|  %8s %4s %10s %4s  %s\n", "uses", "LBD", "lifetime", "rank", "literals");
+    for (size_t i = 0; i < top.size(); i++){
+        const TopClause& t = top[i];
+        printf("|  %8u %4u %10" PRIu64 " %4d ", t.uses, t.lbd, t.life, t.rank);
+        for (size_t j = 0; j < t.lits.size(); j++) printf(" %d", t.lits[j]);
+        printf("\n");
+    }
+}
+
+//=================================================================================================
+// Main:
+
+int main(int argc, char** argv)
+{
+    setUsageHelp("USAGE: %s [options] <clause-log> [<text-file> | <clause-log> ...]\n\n  where <clause-log> is a 'learnt_*' or 'shared_*' log of the solver.\n"
+                 "  Converts a binary log to text (written to standard output if no <text-file> is given), or\n"
+                 "  with '-stats', analyses any number of binary or text logs.\n");
+
+    BoolOption stats("LOGTOOL", "stats", "Print lifetime/use/LBD statistics of the logs instead of converting them.", false);
+    IntOption  top_k("LOGTOOL", "top",   "Number of most used shared clauses to list.\n", 10, IntRange(0, INT32_MAX));
+
+    parseOptions(argc, argv, true);
+
+    if (argc < 2)
+        printf("ERROR! No clause log given. Use '--help' for help.\n"), exit(1);
+
+    if (!stats){
+        ClauseLogReader log;
+        if (!log.open(argv[1]))
+            printf("ERROR! Could not read clause log: %s\n", argv[1]), exit(1);
+
+        FILE* out = argc > 2 ? fopen(argv[2], "w") : stdout;
+        if (out == NULL)
+            printf("ERROR! Could not open file: %s\n", argv[2]), exit(1);
+
+        ClauseRecord r;
+        while (log.next(r))
+            writeText(out, r);
+
+        if (out != stdout) fclose(out);
+        return 0;
+    }
+
+    std::vector<LogSummary> logs;
+    std::vector<TopClause>  top;
+    size_t                  k = top_k;
+    ClauseRecord            r;
+    for (int i = 1; i < argc; i++){
+        LogStream in;
+        if (!in.open(argv[i]))
+            printf("ERROR! Could not read clause log: %s\n", argv[i]), exit(1);
+        logs.push_back(LogSummary(argv[i]));
+        LogSummary& s = logs.back();
+
+        while (in.next(r)){
+            s.add(r);
+            if (!s.shared || k == 0 || (top.size() == k && r.uses <= top.front().uses))
+                continue;
+            if (top.size() == k){
+                std::pop_heap(top.begin(), top.end());
+                top.pop_back(); }
+            TopClause t;
+            t.uses = r.uses; t.lbd = r.lbd; t.life = r.lifetime(); t.rank = s.rank;
+            for (int j = 0; j < r.lits.size(); j++) t.lits.push_back(r.lits[j]);
+            top.push_back(t);
+            std::push_heap(top.begin(), top.end());
+        }
+    }
+
+    for (size_t i = 0; i < logs.size(); i++)
+        printSummary(logs[i]);
+    printComparison(logs);
+    if (k > 0)
+        printTop(top);
+    return 0;
+}
@@ -21,6 +21,10 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef Minisat_Alloc_h
 #define Minisat_Alloc_h
 
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 #include "../mtl/XAlloc.h"
 #include "../mtl/Vec.h"
 
@@ -28,33 +32,43 @@ namespace Minisat {
 
 //=================================================================================================
 // Simple Region-based memory allocator:
-
-template<class T>
+//
+// References are indices of 'T'-sized units into the region, of the unsigned type 'R'. With 32-bit
+// references and 4-byte units a region is limited to 16 GB; 'uint64_t' lifts that limit.
+//
+// By default the region grows with 'realloc()', which may copy it. After 'map()' it lives in a
+// reserved range of address space instead, and grows in place: pages are only backed by memory once
+// they are touched, and 'truncate()' gives the pages after the new end back to the system.
+
+template<class T, class R = uint32_t>
 class RegionAllocator
 {
-    T*        memory;
-    uint32_t  sz;
-    uint32_t  cap;
-    uint32_t  wasted_;
+    T*  memory;
+    R   sz;
+    R   cap;
+    R   wasted_;
+    R   reserved;   // Size of the mapped range in units, or 0 if 'memory' comes from 'realloc()'.
 
-    void capacity(uint32_t min_cap);
+    void capacity(R min_cap);
+    void release ();
 
  public:
     // TODO: make this a class for better type-checking?
-    typedef uint32_t Ref;
-    enum { Ref_Undef = UINT32_MAX };
-    enum { Unit_Size = sizeof(uint32_t) };
-
-    explicit RegionAllocator(uint32_t start_cap = 1024*1024) : memory(NULL), sz(0), cap(0), wasted_(0){ capacity(start_cap); }
-    ~RegionAllocator()
-    {
-        if (memory != NULL)
-            ::free(memory);
-    }
+    typedef R Ref;
+    static const Ref Ref_Undef = ~(Ref)0;
+    enum { Unit_Size = sizeof(T) };
+
+    explicit RegionAllocator(Ref start_cap = 1024*1024) : memory(NULL), sz(0), cap(0), wasted_(0), reserved(0){ capacity(start_cap); }
+    ~RegionAllocator() { release(); }
+
 
+    Ref      size      () const      { return sz; }
+    Ref      wasted    () const      { return wasted_; }
+    bool     mapped    () const      { return reserved > 0; }
+    uint64_t mappedBytes() const     { return (uint64_t)reserved * sizeof(T); }
 
-    uint32_t size      () const      { return sz; }
-    uint32_t wasted    () const      { return wasted_; }
+    bool     map       (uint64_t bytes, bool huge_pages);  // Move to a reserved range of 'bytes'. False if not possible.
+    void     truncate  (Ref new_sz, Ref new_wasted = 0);   // Cut the region to its first 'new_sz' units ('new_wasted' of them unused).
 
     Ref      alloc     (int size); 
     void     free      (int size)    { wasted_ += size; }
@@ -69,31 +83,85 @@ class RegionAllocator
         return  (Ref)(t - &memory[0]); }
 
     void     moveTo(RegionAllocator& to) {
-        if (to.memory != NULL) ::free(to.memory);
+        to.release();
         to.memory = memory;
         to.sz = sz;
         to.cap = cap;
         to.wasted_ = wasted_;
+        to.reserved = reserved;
 
         memory = NULL;
-        sz = cap = wasted_ = 0;
+        sz = cap = wasted_ = reserved = 0;
     }
 
 
 };
 
-template<class T>
-void RegionAllocator<T>::capacity(uint32_t min_cap)
+template<class T, class R>
+void RegionAllocator<T,R>::release()
+{
+    if (memory == NULL) return;
+    if (reserved > 0)
+        munmap(memory, (size_t)reserved * sizeof(T));
+    else
+        ::free(memory);
+    memory = NULL;
+}
+
+
+template<class T, class R>
+bool RegionAllocator<T,R>::map(uint64_t bytes, bool huge_pages)
+{
+    uint64_t units = bytes / sizeof(T);
+    if (units > (uint64_t)(R)~(R)0) units = (R)~(R)0;
+    if (units < sz) return false;
+
+    void* mem = mmap(NULL, (size_t)units * sizeof(T), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mem == MAP_FAILED) return false;
+#ifdef MADV_HUGEPAGE
+    if (huge_pages)
+        madvise(mem, (size_t)units * sizeof(T), MADV_HUGEPAGE);
+#endif
+
+    if (sz > 0) memcpy(mem, memory, (size_t)sz * sizeof(T));
+    release();
+    memory   = (T*)mem;
+    cap      = units;
+    reserved = units;
+    return true;
+}
+
+
+template<class T, class R>
+void RegionAllocator<T,R>::truncate(R new_sz, R new_wasted)
+{
+    assert(new_sz <= sz);
+    if (reserved > 0){
+        // Give back the pages after the new end (they are zero again when touched next):
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        size_t from = ((size_t)new_sz * sizeof(T) + page - 1) / page * page;
+        size_t to   = (size_t)sz * sizeof(T);
+        if (to > from)
+            madvise((char*)memory + from, to - from, MADV_DONTNEED);
+    }
+    sz      = new_sz;
+    wasted_ = new_wasted;
+}
+
+
+template<class T, class R>
+void RegionAllocator<T,R>::capacity(R min_cap)
 {
     if (cap >= min_cap) return;
+    if (reserved > 0) throw OutOfMemoryException();   // (A mapped region never moves.)
 
-    uint32_t prev_cap = cap;
+    R prev_cap = cap;
     while (cap < min_cap){
         // NOTE: Multiply by a factor (13/8) without causing overflow, then add 2 and make the
         // result even by clearing the least significant bit. The resulting sequence of capacities
         // is carefully chosen to hit a maximum capacity that is close to the '2^32-1' limit when
         // using 'uint32_t' as indices so that as much as possible of this space can be used.
-        uint32_t delta = ((cap >> 1) + (cap >> 3) + 2) & ~1;
+        R delta = ((cap >> 1) + (cap >> 3) + 2) & ~(R)1;
         cap += delta;
 
         if (cap <= prev_cap)
@@ -106,15 +174,15 @@ void RegionAllocator<T>::capacity(uint32_t min_cap)
 }
 
 
-template<class T>
-typename RegionAllocator<T>::Ref
-RegionAllocator<T>::alloc(int size)
+template<class T, class R>
+typename RegionAllocator<T,R>::Ref
+RegionAllocator<T,R>::alloc(int size)
 { 
     // printf("ALLOC called (this = %p, size = %d)\n", this, size); fflush(stdout);
     assert(size > 0);
     capacity(sz + size);
 
-    uint32_t prev_sz = sz;
+    R prev_sz = sz;
     sz += size;
     
     // Handle overflow:
@@ -142,6 +142,174 @@ class Heap {
 };
 
 
+//=================================================================================================
+// A d-ary heap that keeps a copy of each element's key next to it, so that comparisons do not have
+// to look the keys up in 'keys' (and the 'D' children of a node are adjacent in memory). When the key
+// of an element changes in 'keys', the heap only notices on 'decrease()', 'increase()', 'update()' or
+// 'updateMany()' of that element. If all keys were scaled by the same positive factor, 'reloadKeys()'
+// refreshes the copies without moving anything.
+
+
+template<class K, class Comp, int D = 4>
+class KeyHeap {
+    struct Elem { K key; int n; };
+
+    const vec<K>& keys;     // The current key of each integer
+    Comp          lt;       // The heap is a minimum-heap with respect to this comparator (on keys)
+    vec<Elem>     heap;     // Heap of integers, with their keys as of their last update
+    vec<int>      indices;  // Each integers position (index) in the Heap
+
+    // Index "traversal" functions
+    static inline int child (int i) { return i*D+1; }   // (the first one)
+    static inline int parent(int i) { return (i-1) / D; }
+
+
+    void percolateUp(int i)
+    {
+        Elem x = heap[i];
+        while (i != 0 && lt(x.key, heap[parent(i)].key)){
+            heap[i]            = heap[parent(i)];
+            indices[heap[i].n] = i;
+            i                  = parent(i);
+        }
+        heap   [i]   = x;
+        indices[x.n] = i;
+    }
+
+
+    void percolateDown(int i)
+    {
+        Elem x = heap[i];
+        while (child(i) < heap.size()){
+            int first = child(i);
+            int last  = first + D < heap.size() ? first + D : heap.size();
+            int best  = first;
+            for (int c = first + 1; c < last; c++)
+                if (lt(heap[c].key, heap[best].key))
+                    best = c;
+            if (!lt(heap[best].key, x.key)) break;
+            heap[i]            = heap[best];
+            indices[heap[i].n] = i;
+            i                  = best;
+        }
+        heap   [i]   = x;
+        indices[x.n] = i;
+    }
+
+
+    void heapify()
+    {
+        if (heap.size() > 1)
+            for (int i = parent(heap.size() - 1); i >= 0; i--)
+                percolateDown(i);
+    }
+
+
+  public:
+    KeyHeap(const vec<K>& ks, const Comp& c = Comp()) : keys(ks), lt(c) { }
+
+    int  size      ()          const { return heap.size(); }
+    bool empty     ()          const { return heap.size() == 0; }
+    bool inHeap    (int n)     const { return n < indices.size() && indices[n] >= 0; }
+    int  operator[](int index) const { assert(index < heap.size()); return heap[index].n; }
+
+
+    void decrease  (int n) { assert(inHeap(n)); heap[indices[n]].key = keys[n]; percolateUp  (indices[n]); }
+    void increase  (int n) { assert(inHeap(n)); heap[indices[n]].key = keys[n]; percolateDown(indices[n]); }
+
+
+    // Safe variant of insert/decrease/increase:
+    void update(int n)
+    {
+        if (!inHeap(n))
+            insert(n);
+        else {
+            int i   = indices[n];
+            K   old = heap[i].key;
+            heap[i].key = keys[n];
+            if (lt(heap[i].key, old))
+                percolateUp(i);
+            else if (lt(old, heap[i].key))
+                percolateDown(i); }
+    }
+
+
+    // Update those of the integers 'ns' that are in the heap. If many keys have changed, rebuilding the
+    // whole heap is cheaper than moving the elements one by one:
+    template<class V>
+    void updateMany(const V& ns)
+    {
+        int depth = 0;
+        for (int s = heap.size(); s > 0; s /= D)
+            depth++;
+        if ((int64_t)ns.size() * depth <= heap.size()){
+            for (int i = 0; i < ns.size(); i++)
+                if (inHeap(ns[i]))
+                    update(ns[i]);
+        }else{
+            for (int i = 0; i < ns.size(); i++)
+                if (inHeap(ns[i]))
+                    heap[indices[ns[i]]].key = keys[ns[i]];
+            heapify();
+        }
+    }
+
+
+    void reloadKeys()
+    {
+        for (int i = 0; i < heap.size(); i++)
+            heap[i].key = keys[heap[i].n];
+    }
+
+
+    void insert(int n)
+    {
+        indices.growTo(n+1, -1);
+        assert(!inHeap(n));
+
+        Elem e = { keys[n], n };
+        indices[n] = heap.size();
+        heap.push(e);
+        percolateUp(indices[n]);
+    }
+
+
+    int  removeMin()
+    {
+        int x              = heap[0].n;
+        heap[0]            = heap.last();
+        indices[heap[0].n] = 0;
+        indices[x]         = -1;
+        heap.pop();
+        if (heap.size() > 1) percolateDown(0);
+        return x;
+    }
+
+
+    // Rebuild the heap from scratch, using the elements in 'ns':
+    void build(vec<int>& ns) {
+        for (int i = 0; i < heap.size(); i++)
+            indices[heap[i].n] = -1;
+        heap.clear();
+
+        for (int i = 0; i < ns.size(); i++){
+            Elem e = { keys[ns[i]], ns[i] };
+            indices.growTo(ns[i]+1, -1);
+            indices[ns[i]] = i;
+            heap.push(e); }
+
+        heapify();
+    }
+
+    void clear(bool dealloc = false)
+    {
+        for (int i = 0; i < heap.size(); i++)
+            indices[heap[i].n] = -1;
+        heap.clear(dealloc);
+    }
+};
+
+
 //=================================================================================================
 }
 
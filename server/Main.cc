@@ -0,0 +1,511 @@
+/*****************************************************************************************[Main.cc]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <zlib.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../utils/System.h"
+#include "../utils/ParseUtils.h"
+#include "../utils/Options.h"
+#include "../core/Dimacs.h"
+#include "../core/SimdScan.h"
+#include "../simp/ParallelSolver.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Solve server:
+//
+// Listens on a Unix domain socket. Every connection sends newline-terminated commands and receives
+// one JSON object per line in return:
+//
+//   load   <name> <file> [solvers=N] [pre=0|1]      Parse a (gzipped) DIMACS file into formula <name>.
+//   dimacs <name> <bytes> [solvers=N] [pre=0|1]     Same, with the next <bytes> bytes as DIMACS payload.
+//   add    <name> <lit>... 0                        Add a clause to a loaded formula.
+//   solve  <name> [time=S] [conf=N] [progress=S] [model=0|1] [assume <lit>... 0]
+//   cancel <job>                                    Interrupt a running job.
+//   drop   <name>                                   Forget a formula.
+//   quit                                            Close the connection (its running jobs are cancelled).
+//
+// Formulas stay loaded (and preprocessed) between requests; every 'solve' is an incremental call on
+// the same portfolio, so learnt and shared clauses carry over. All variables of a loaded formula are
+// frozen, so assumptions and added clauses may use any of them. A formula runs one job at a time;
+// further jobs on it wait for their turn, and clauses cannot be added to it while a job runs.
+
+typedef std::chrono::steady_clock Clock;
+
+static double seconds(Clock::time_point from) { return std::chrono::duration<double>(Clock::now() - from).count(); }
+
+static int listen_fd = -1;
+
+static void SIGINT_stop(int signum) { if (listen_fd != -1) shutdown(listen_fd, SHUT_RDWR); }
+
+static int max_vars = 0;       // Variables above this are rejected (solver memory grows with the largest one).
+
+//-------------------------------------------------------------------------------------------------
+// DIMACS from memory:
+
+
+class MemStream {
+    const std::string& buf;
+    size_t             pos;
+public:
+    explicit MemStream(const std::string& b) : buf(b), pos(0) {}
+    int  operator *  () const { return pos >= buf.size() ? EOF : (unsigned char)buf[pos]; }
+    void operator ++ ()       { pos++; }
+};
+
+static inline bool isEof(MemStream& in) { return *in == EOF; }
+
+// The DIMACS parser exits on malformed input, which must not take the server down. This accepts
+// exactly the inputs the parser does: comments and 'p cnf' headers between clauses, and clauses of
+// whitespace separated integers terminated by 0. Integers must fit in an 'int', the variables of the
+// clauses must not exceed 'max_vars', and no clause may be longer than 'Clause::max_size'.
+static bool validDimacs(const std::string& s)
+{
+    size_t i = 0, n = s.size();
+    bool   in_clause = false;
+    int    size      = 0;           // Literals of the current clause.
+    int    header    = 0;           // Integers still expected after 'p cnf'.
+    for (;;){
+        while (i < n && (s[i] == ' ' || (s[i] >= 9 && s[i] <= 13))) i++;
+        if (i == n) return !in_clause && header == 0;
+
+        if (!in_clause && header == 0 && s[i] == 'c')
+            while (i < n && s[i] != '\n') i++;
+        else if (!in_clause && header == 0 && s[i] == 'p'){
+            if (s.compare(i, 5, "p cnf") != 0) return false;
+            i += 5, header = 2;
+        }else{
+            long long val = 0;
+            if (s[i] == '-' || s[i] == '+') i++;
+            if (i == n || s[i] < '0' || s[i] > '9') return false;
+            for (; i < n && s[i] >= '0' && s[i] <= '9'; i++)
+                if ((val = val*10 + (s[i] - '0')) > INT32_MAX) return false;
+            if      (header > 0)     header--;
+            else if (val > max_vars) return false;
+            else if (val == 0)       in_clause = false, size = 0;
+            else if (++size > Clause::max_size) return false;
+            else                     in_clause = true;
+        }
+    }
+}
+
+static bool readFile(const std::string& file, std::string& out)
+{
+    gzFile in = gzopen(file.c_str(), "rb");
+    if (in == NULL) return false;
+    char buf[65536];
+    int  n;
+    while ((n = gzread(in, buf, sizeof(buf))) > 0)
+        out.append(buf, n);
+    gzclose(in);
+    return n == 0;
+}
+
+//-------------------------------------------------------------------------------------------------
+// Connections, formulas and jobs:
+
+
+class Connection {
+    int         fd;
+    std::mutex  out_mtx;
+    std::string in_buf;
+
+    bool fill() {
+        char buf[65536];
+        ssize_t n;
+        do n = read(fd, buf, sizeof(buf)); while (n < 0 && errno == EINTR);
+        if (n <= 0) return false;
+        in_buf.append(buf, n);
+        return true; }
+
+public:
+    explicit Connection(int f) : fd(f) {}
+    ~Connection() { close(fd); }
+
+    bool readLine(std::string& line) {
+        size_t nl;
+        while ((nl = in_buf.find('\n')) == std::string::npos)
+            if (!fill()) return false;
+        line.assign(in_buf, 0, nl);
+        in_buf.erase(0, nl + 1);
+        if (!line.empty() && line[line.size()-1] == '\r') line.erase(line.size()-1);
+        return true; }
+
+    bool readBytes(size_t n, std::string& out) {
+        while (in_buf.size() < n)
+            if (!fill()) return false;
+        out.assign(in_buf, 0, n);
+        in_buf.erase(0, n);
+        return true; }
+
+    void send(const std::string& json) {
+        std::lock_guard<std::mutex> lock(out_mtx);
+        std::string line = json + "\n";
+        for (size_t done = 0; done < line.size(); ){
+            ssize_t n = write(fd, line.data() + done, line.size() - done);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return;                                 // (client went away; results are dropped)
+            done += n; } }
+};
+
+struct Formula {
+    std::mutex                      mtx;   // Held by the job using the formula.
+    std::unique_ptr<ParallelSolver> S;
+};
+
+struct Job {
+    int                         id;
+    std::shared_ptr<Formula>    formula;
+    std::atomic<bool>           cancel;
+    std::atomic<bool>           done;
+    std::thread                 thread;
+    Job() : id(0), cancel(false), done(false) {}
+};
+
+static std::mutex                                       formulas_mtx;
+static std::map<std::string, std::shared_ptr<Formula> > formulas;
+static std::atomic<int>                                 next_job(1);
+
+static std::mutex                                       jobs_mtx;
+static std::map<int, std::shared_ptr<Job> >             jobs;
+
+static std::string jsonString(const std::string& s)
+{
+    std::string r = "\"";
+    for (size_t i = 0; i < s.size(); i++){
+        unsigned char c = s[i];
+        if      (c == '"' || c == '\\') { r += '\\'; r += c; }
+        else if (c < 0x20)              { char buf[8]; snprintf(buf, sizeof(buf), "\\u%04x", c); r += buf; }
+        else                            r += c;
+    }
+    return r + "\"";
+}
+
+static std::string error(const std::string& msg) { return "{\"event\":\"error\",\"message\":" + jsonString(msg) + "}"; }
+
+static std::shared_ptr<Formula> findFormula(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(formulas_mtx);
+    std::map<std::string, std::shared_ptr<Formula> >::iterator it = formulas.find(name);
+    return it == formulas.end() ? std::shared_ptr<Formula>() : it->second;
+}
+
+// Reads "key=value" into 'val' if 'tok' starts with "key=":
+static bool option(const std::string& tok, const char* key, double& val)
+{
+    size_t n = strlen(key);
+    if (tok.compare(0, n, key) != 0 || tok.size() <= n || tok[n] != '=') return false;
+    val = atof(tok.c_str() + n + 1);
+    return true;
+}
+
+// Returns NULL on success, or what is wrong with the literals:
+static const char* readLits(std::istringstream& in, vec<Lit>& lits)
+{
+    long long x;               // (wider than the variables, so that '-x' cannot overflow)
+    lits.clear();
+    while (in >> x){
+        if (x == 0) return NULL;
+        if (x < -max_vars || x > max_vars) return "has a variable out of range";
+        if (lits.size() == Clause::max_size) return "has too many literals";
+        lits.push(x > 0 ? mkLit((Var)x-1) : ~mkLit((Var)-x-1)); }
+    return in.eof() ? "must end with 0" : "has a malformed literal";
+}
+
+//-------------------------------------------------------------------------------------------------
+// Commands:
+
+
+static std::string loadFormula(const std::string& name, const std::string& dimacs, std::istringstream& opts)
+{
+    double solvers = 1, pre = 1;
+    std::string tok;
+    while (opts >> tok)
+        if (!option(tok, "solvers", solvers) && !option(tok, "pre", pre))
+            return error("unknown option: " + tok);
+    if (solvers < 1 || solvers > 4)
+        return error("solvers must be between 1 and 4");
+    if (!validDimacs(dimacs))
+        return error("malformed DIMACS");
+
+    Clock::time_point start = Clock::now();
+    std::shared_ptr<Formula> f(new Formula);
+    f->S.reset(new ParallelSolver((int)solvers));
+    ParallelSolver& S = *f->S;
+    S.setVerbosity(0);
+    MemStream in(dimacs);
+    parse_DIMACS_main(in, S);
+    for (Var v = 0; v < S.nVars(); v++)
+        S.setFrozen(v, true);
+    if (pre)
+        S.eliminate(true);     // (subsumption and strengthening only: every variable is frozen)
+
+    {
+        std::lock_guard<std::mutex> lock(formulas_mtx);
+        formulas[name] = f;
+    }
+    char buf[256];
+    snprintf(buf, sizeof(buf), "{\"event\":\"loaded\",\"name\":%s,\"vars\":%d,\"clauses\":%d,\"okay\":%s,\"time\":%.3f}",
+             jsonString(name).c_str(), S.nVars(), S.nClauses(), S.okay() ? "true" : "false", seconds(start));
+    return buf;
+}
+
+
+static void runJob(std::shared_ptr<Job> job, std::shared_ptr<Connection> conn, std::unique_ptr<vec<Lit> > assumps,
+                   double time_lim, double conf_lim, double progress, bool with_model)
+{
+    std::unique_lock<std::mutex> lock(job->formula->mtx);
+    ParallelSolver& S = *job->formula->S;
+    char buf[256];
+
+    Clock::time_point start = Clock::now();
+    double            last  = 0;
+    const char*       reason = NULL;
+    snprintf(buf, sizeof(buf), "{\"job\":%d,\"event\":\"started\"}", job->id);
+    conn->send(buf);
+
+    // Budgets, cancellation and progress reports are all handled between scheduler rounds:
+    S.setProgressCallback([&](ParallelSolver& P){
+        double t = seconds(start);
+        if (progress > 0 && t - last >= progress){
+            uint64_t confl = 0;
+            for (int i = 0; i < P.nInstances(); i++) confl += P.instance(i).conflicts;
+            snprintf(buf, sizeof(buf), "{\"job\":%d,\"event\":\"progress\",\"time\":%.3f,\"conflicts\":%" PRIu64 ",\"finished\":%d}",
+                     job->id, t, confl, P.nFinished());
+            conn->send(buf);
+            last = t; }
+        if      (job->cancel) reason = "cancelled";
+        else if (t > time_lim) reason = "time";
+        else return;
+        P.interrupt();
+    }, 64);
+
+    if (conf_lim > 0) S.setConfBudget((int64_t)conf_lim); else S.budgetOff();
+    S.setStopOnFirst(true);     // (only the winner is reported)
+
+    for (int i = 0; i < assumps->size(); i++)
+        while (var((*assumps)[i]) >= S.nVars()) S.newVar();
+    bool  solved = S.okay();
+    lbool ret    = solved ? S.solveLimited(*assumps) : l_False;
+    S.budgetOff();
+    S.clearInterrupt();
+    S.setProgressCallback(ParallelSolver::ProgressCallback());
+
+    std::string r;
+    snprintf(buf, sizeof(buf), "{\"job\":%d,\"event\":\"result\",\"result\":\"%s\",\"time\":%.3f,\"winner\":%d",
+             job->id, ret == l_True ? "SAT" : ret == l_False ? "UNSAT" : "INDET", seconds(start), S.winner());
+    r = buf;
+    if (ret == l_Undef)
+        r += std::string(",\"reason\":\"") + (reason != NULL ? reason : "budget") + "\"";
+    if (ret == l_True && with_model){
+        r += ",\"model\":[";
+        for (int i = 0; i < S.nVars(); i++)
+            if (S.model[i] != l_Undef){
+                snprintf(buf, sizeof(buf), "%s%s%d", i == 0 ? "" : ",", S.model[i] == l_True ? "" : "-", i+1);
+                r += buf; }
+        r += "]"; }
+    if (ret == l_False && solved && S.conflict.size() > 0){
+        // The failed assumptions, with the signs they were given in:
+        r += ",\"failed\":[";
+        for (int i = 0; i < S.conflict.size(); i++){
+            snprintf(buf, sizeof(buf), "%s%s%d", i == 0 ? "" : ",", sign(S.conflict[i]) ? "" : "-", var(S.conflict[i])+1);
+            r += buf; }
+        r += "]"; }
+    lock.unlock();                     // (the formula is free once the client learns the result)
+    conn->send(r + "}");
+
+    std::lock_guard<std::mutex> jl(jobs_mtx);
+    jobs.erase(job->id);
+    job->done = true;
+}
+
+
+static void serve(std::shared_ptr<Connection> conn)
+{
+    std::vector<std::shared_ptr<Job> > own;
+    std::string line;
+    while (conn->readLine(line)){
+        std::istringstream in(line);
+        std::string cmd, name;
+        in >> cmd;
+        if (cmd.empty()) continue;
+
+        if (cmd == "quit")
+            break;
+
+        else if (cmd == "load" || cmd == "dimacs"){
+            std::string dimacs;
+            if (!(in >> name)){ conn->send(error("missing formula name")); continue; }
+            if (cmd == "load"){
+                std::string file;
+                if (!(in >> file) || !readFile(file, dimacs)){ conn->send(error("could not read file")); continue; }
+            }else{
+                long long bytes;
+                if (!(in >> bytes) || bytes < 0){ conn->send(error("missing payload size")); continue; }
+                if (!conn->readBytes((size_t)bytes, dimacs)) break;
+            }
+            try {
+                conn->send(loadFormula(name, dimacs, in));
+            } catch (OutOfMemoryException&){
+                conn->send(error("out of memory")); }
+
+        }else if (cmd == "add"){
+            vec<Lit>    lits;
+            const char* err;
+            in >> name;
+            std::shared_ptr<Formula> f = findFormula(name);
+            if (!f)                   { conn->send(error("unknown formula: " + name)); continue; }
+            if ((err = readLits(in, lits)) != NULL){ conn->send(error(std::string("clause ") + err)); continue; }
+            std::unique_lock<std::mutex> lock(f->mtx, std::try_to_lock);
+            if (!lock.owns_lock()){ conn->send(error("formula is busy: " + name)); continue; }
+            for (int i = 0; i < lits.size(); i++)
+                while (var(lits[i]) >= f->S->nVars()) f->S->newVar();
+            f->S->addClause(lits);
+            conn->send(std::string("{\"event\":\"added\",\"okay\":") + (f->S->okay() ? "true" : "false") + "}");
+
+        }else if (cmd == "solve"){
+            double time_lim = 1e300, conf_lim = 0, progress = 1, model = 0;
+            std::unique_ptr<vec<Lit> > assumps(new vec<Lit>());
+            bool ok = true;
+            const char* err = NULL;
+            std::string tok;
+            in >> name;
+            while (ok && in >> tok){
+                if (tok == "assume")
+                    ok = (err = readLits(in, *assumps)) == NULL;
+                else if (!option(tok, "time", time_lim) && !option(tok, "conf", conf_lim)
+                      && !option(tok, "progress", progress) && !option(tok, "model", model)){
+                    conn->send(error("unknown option: " + tok)); ok = false; tok.clear(); }
+            }
+            std::shared_ptr<Formula> f = findFormula(name);
+            if (!ok || !f){
+                if (!f) conn->send(error("unknown formula: " + name));
+                else if (err != NULL) conn->send(error(std::string("assumptions ") + err));
+                continue; }
+
+            // Reap the jobs of this connection that have finished:
+            for (size_t i = 0; i < own.size(); )
+                if (own[i]->done){
+                    own[i]->thread.join();
+                    own[i] = own.back(), own.pop_back();
+                }else i++;
+
+            std::shared_ptr<Job> job(new Job);
+            job->id      = next_job++;
+            job->formula = f;
+            {
+                std::lock_guard<std::mutex> lock(jobs_mtx);
+                jobs[job->id] = job;
+            }
+            char buf[64];
+            snprintf(buf, sizeof(buf), "{\"job\":%d,\"event\":\"accepted\"}", job->id);
+            conn->send(buf);
+            job->thread = std::thread(runJob, job, conn, std::move(assumps), time_lim, conf_lim, progress, model != 0);
+            own.push_back(job);
+
+        }else if (cmd == "cancel"){
+            int id = 0;
+            in >> id;
+            std::lock_guard<std::mutex> lock(jobs_mtx);
+            std::map<int, std::shared_ptr<Job> >::iterator it = jobs.find(id);
+            if (it == jobs.end())
+                conn->send(error("no such running job"));
+            else
+                it->second->cancel = true;     // (the job interrupts its solver at the next round)
+
+        }else if (cmd == "drop"){
+            in >> name;
+            std::lock_guard<std::mutex> lock(formulas_mtx);
+            conn->send(formulas.erase(name) ? "{\"event\":\"dropped\"}" : error("unknown formula: " + name));
+
+        }else
+            conn->send(error("unknown command: " + cmd));
+    }
+
+    // The connection is gone; its jobs have nobody to report to:
+    for (size_t i = 0; i < own.size(); i++){
+        own[i]->cancel = true;
+        own[i]->thread.join(); }
+}
+
+//=================================================================================================
+// Main:
+
+int main(int argc, char** argv)
+{
+    setUsageHelp("USAGE: %s [options]\n\n  Serves solve requests on a Unix domain socket (see server/Main.cc for the protocol).\n");
+
+#if defined(__linux__)
+    fpu_control_t oldcw, newcw;
+    _FPU_GETCW(oldcw); newcw = (oldcw & ~_FPU_EXTENDED) | _FPU_DOUBLE; _FPU_SETCW(newcw);
+#endif
+    // Extra options:
+    //
+    StringOption socket_path("SERVER", "socket",   "Path of the Unix domain socket to listen on.", "/tmp/maplesat.sock");
+    IntOption    opt_max_vars("SERVER", "max-vars", "Largest variable accepted in formulas, clauses and assumptions.\n", 1 << 24, IntRange(1, (1 << 30) - 1));
+
+    parseOptions(argc, argv, true);
+    selectSimdScan();
+    max_vars = opt_max_vars;
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(addr.sun_path))
+        printf("ERROR! Socket path too long: %s\n", (const char*)socket_path), exit(1);
+    strcpy(addr.sun_path, socket_path);
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socket_path);
+    if (listen_fd == -1 || bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) == -1 || listen(listen_fd, 16) == -1)
+        printf("ERROR! Could not listen on socket: %s (%s)\n", (const char*)socket_path, strerror(errno)), exit(1);
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT,  SIGINT_stop);
+    signal(SIGTERM, SIGINT_stop);
+
+    for (;;){
+        int fd = accept(listen_fd, NULL, NULL);
+        if (fd == -1){
+            if (errno == EINTR) continue;
+            break; }
+        std::shared_ptr<Connection> conn(new Connection(fd));
+        std::thread(serve, conn).detach();
+    }
+
+    close(listen_fd);
+    unlink(socket_path);
+    _exit(0);                  // (running jobs are abandoned)
+}
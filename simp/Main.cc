@@ -19,22 +19,20 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 **************************************************************************************************/
 
 #include <errno.h>
+#include <vector>
 
 #include <signal.h>
 #include <zlib.h>
 #include <sys/resource.h>
+#include <sys/stat.h>
 #include <mpi.h>
 #include "../utils/System.h"
 #include "../utils/ParseUtils.h"
 #include "../utils/Options.h"
 #include "../core/Dimacs.h"
-#include "../simp/SimpSolver.h"
-#include <boost/coroutine2/all.hpp>
-#include <boost/bind.hpp>
+#include "../core/SimdScan.h"
+#include "../simp/ParallelSolver.h"
 #include <iostream>
-#include <vector>
-#include <sys/types.h>
-#include <sys/stat.h>
 using namespace Minisat;
 
 //=================================================================================================
@@ -64,25 +62,54 @@ void printStats(Solver& solver)
 }
 
 
-//static Solver* solver;
-//static Solver* solver1;
-static std::vector<Solver *> solver_ptrs;
+// Parses a comma-separated list of integers in [0, max] into 'out' (FALSE if it is malformed):
+static bool parseInstList(const char* list, int max, vec<int>& out)
+{
+    out.clear();
+    for (const char* p = list; *p != '\0'; p++){
+        char* end;
+        long  m = strtol(p, &end, 10);
+        if (end == p || m < 0 || m > max || (*end != ',' && *end != '\0'))
+            return false;
+        out.push(m);
+        p = *end == '\0' ? end - 1 : end;
+    }
+    return out.size() > 0;
+}
+
+
+// Parses a comma-separated list of rephasing schedules (letters of "OIBRW", or "-" for none) into 'out'
+// (FALSE if it is malformed):
+static bool parseRephaseList(const char* list, std::vector<std::string>& out)
+{
+    out.clear();
+    std::string s(list);
+    for (size_t p = 0; p <= s.size(); ){
+        size_t end = s.find(',', p);
+        if (end == std::string::npos) end = s.size();
+        std::string r = s.substr(p, end - p);
+        if (r == "-") r = "";
+        else if (r.empty() || r.find_first_not_of("OIBRW") != std::string::npos)
+            return false;
+        out.push_back(r);
+        p = end + 1;
+    }
+    return true;
+}
+
+
+static ParallelSolver* psolver;
 // Terminate by notifying the solver and back out gracefully. This is mainly to have a test-case
 // for this feature of the Solver as it may take longer than an immediate call to '_exit()'.
-static void SIGINT_interrupt(int signum) {
-//    solver->interrupt();
-//    solver1->interrupt();
-    for(Solver* s : solver_ptrs) s->interrupt();
-}
+static void SIGINT_interrupt(int signum) { psolver->interrupt(); }
 
 // Note that '_exit()' rather than 'exit()' has to be used. The reason is that 'exit()' calls
 // destructors and may cause deadlocks if a malloc/free function happens to be running (these
 // functions are guarded by locks for multithreaded use).
 static void SIGINT_exit(int signum) {
     printf("\n"); printf("*** INTERRUPTED ***\n");
-    if (solver_ptrs[0]->verbosity/*solver->verbosity*/ > 0){
-        printStats(/*solver*/*solver_ptrs[0]);
-//        printStats(*solver1);
+    if (psolver->instance(0).verbosity > 0){
+        printStats(psolver->instance(0));
         printf("\n"); printf("*** INTERRUPTED ***\n"); }
     _exit(1); }
 
@@ -110,62 +137,79 @@ int main(int argc, char** argv)
         IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", INT32_MAX, IntRange(0, INT32_MAX));
         // adding options to take number of solvers instances
         IntOption num_solvers    ("MAIN", "solvers", "Number of solver instances to execute in interleaved manner.\n", 1, IntRange(1, 4));
+        // coroutine stacks of the solver instances:
+        StringOption stack_kind  ("MAIN", "stack", "Coroutine stack allocator (fixed, protected, pooled, segmented).", "fixed");
+        IntOption    stack_size  ("MAIN", "stack-size", "Coroutine stack size in kilobytes (0 = Boost default).", 0, IntRange(0, INT32_MAX));
+        BoolOption   stack_stats ("MAIN", "stack-stats", "Report the stack high-water mark of each instance.", false);
+        BoolOption   clause_log  ("MAIN", "clause-log", "Write the binary learnt/shared clause logs (see 'maplesat_logtool').", true);
+        StringOption inst_restarts("MAIN", "inst-restarts", "Restart policy of each instance as a comma-separated list, cycled over the instances (overrides -restarts).");
+        StringOption inst_vmtf   ("MAIN", "inst-vmtf", "Decision queue of each instance (0=activity heap, 1=VMTF) as a comma-separated list, cycled over the instances (overrides -vmtf).");
+        StringOption inst_rephase("MAIN", "inst-rephase", "Rephasing schedule of each instance as a comma-separated list ('-' for none), cycled over the instances (overrides -rephase).");
+        StringOption inst_walk   ("MAIN", "inst-walk", "Search of each instance (0=CDCL, 1=local search) as a comma-separated list, cycled over the instances (overrides -walk).");
+        IntOption    phase_xchg  ("MAIN", "phase-exchange", "Rounds of the scheduler between two phase exchanges with the local search instances (0=never).", 10000, IntRange(0, INT32_MAX));
 
         parseOptions(argc, argv, true);
-        
-
-        SimpSolver solvers[(int) num_solvers];
-        int num_instances = (int)num_solvers;
-        for(int i = 0 ; i < num_instances ; i ++){
-            solver_ptrs.push_back(&solvers[i]);
+        selectSimdScan();
+
+        StackKind kind;
+        if (!StackAllocator::parseKind(stack_kind, kind))
+            printf("ERROR! Unsupported stack allocator: %s\n", (const char*)stack_kind), exit(1);
+        size_t ssize = stack_size == 0 ? StackAllocator::traits_type::default_size() : (size_t)stack_size * 1024;
+        if (ssize < StackAllocator::traits_type::minimum_size())
+            ssize = StackAllocator::traits_type::minimum_size();
+
+        ParallelSolver S(num_solvers, StackAllocator(kind, ssize, stack_stats));
+        psolver = &S;
+
+        vec<int> modes;
+        if (inst_restarts){
+            if (!parseInstList(inst_restarts, 2, modes))
+                printf("ERROR! Invalid restart policy list: %s\n", (const char*)inst_restarts), exit(1);
+            for (int i = 0; i < S.nInstances(); i++)
+                S.instance(i).restart_mode = modes[i % modes.size()];
         }
-//        SimpSolver S0/*, S1*/;
-        int count = 0;
-        for(SimpSolver& S : solvers){
-                S.Mpi_rank = count++;
-                S.random_seed = S.Mpi_rank * S.random_seed + 273647;
-//                S.iterations = 0; //moved into the constructor
+        if (inst_vmtf){
+            if (!parseInstList(inst_vmtf, 1, modes))
+                printf("ERROR! Invalid decision queue list: %s\n", (const char*)inst_vmtf), exit(1);
+            for (int i = 0; i < S.nInstances(); i++)
+                S.instance(i).vmtf = modes[i % modes.size()];
         }
-//        S0.Mpi_rank = 0;
-//        S1.Mpi_rank = 1;
+        if (S.instance(0).rephase.find_first_not_of("OIBRW") != std::string::npos)
+            printf("ERROR! Invalid rephasing schedule: %s\n", S.instance(0).rephase.c_str()), exit(1);
+        if (inst_rephase){
+            std::vector<std::string> schedules;
+            if (!parseRephaseList(inst_rephase, schedules))
+                printf("ERROR! Invalid rephasing schedule list: %s\n", (const char*)inst_rephase), exit(1);
+            for (int i = 0; i < S.nInstances(); i++)
+                S.instance(i).rephase = schedules[i % schedules.size()];
+        }
+        if (inst_walk){
+            if (!parseInstList(inst_walk, 1, modes))
+                printf("ERROR! Invalid search list: %s\n", (const char*)inst_walk), exit(1);
+            for (int i = 0; i < S.nInstances(); i++)
+                S.instance(i).walk = modes[i % modes.size()];
+        }
+        S.setPhaseExchange(phase_xchg);
+
         /* Creating directories and files -----------------------------*/
-        std::string problemName = argv[1];
+        std::string problemName = argc == 1 ? "stdin" : argv[1];
         std::string delimeter = "/";
         size_t pos = 0;
-        std::string token;
         while ((pos = problemName.find(delimeter)) != std::string::npos){
-//            token = problemName.substr(0, pos);
             problemName.erase(0, pos+delimeter.length());
         }
-        mkdir(problemName.c_str(), 0777); //creating directory of name same as instance name
-
-        for(SimpSolver& S: solvers){
-            S.sFileName = "./"+ problemName + "/" + "shared_" + std::to_string(S.Mpi_rank)+".txt";
-//            std::cout << S.sFileName <<"here"<<std::endl;
-            S.lFileName = "./"+ problemName + "/" + "learnt_" + std::to_string(S.Mpi_rank)+".txt";
-            S.sfile.open(S.sFileName);
-            S.lfile.open(S.lFileName);
-        }
-
+        std::string outDir = "./" + problemName; //creating directory of name same as instance name
+        mkdir(outDir.c_str(), 0777);
+        if (clause_log && !S.openLogs(outDir))
+            printf("WARNING! Could not open the clause logs in: %s\n", outDir.c_str());
 
         /*-------------------------------------------------------------------------*/
 
         double      initial_time = cpuTime();
 
-        if (!pre) {
-//            S0.eliminate(true);
-//            S1.eliminate(true);
-            for(SimpSolver& S :solvers) S.eliminate(true);
-        }
+        if (!pre) S.eliminate(true);
 
-//        S0.verbosity = verb;
-//        S1.verbosity = verb;
-//        solver_ptrs.push_back(&S0);
-//        solver = &S0;  //handled up there in first loop
-//        solver1 = &S1; //handled up there in first loop
-        for(SimpSolver& S :solvers){
-            S.verbosity = verb;
-        }
+        S.setVerbosity(verb);
         // Use signal handlers that forcibly quit until the solver will be able to respond to
         // interrupts:
         signal(SIGINT, SIGINT_exit);
@@ -181,9 +225,10 @@ int main(int argc, char** argv)
                     printf("WARNING! Could not set resource limit: CPU-time.\n");
             } }
 
-        // Set limit on virtual memory:
+        // Set limit on virtual memory (reserved clause arenas are address space only, so they come on top;
+        // their growth is bounded by '-arena-gb' instead):
         if (mem_lim != INT32_MAX){
-            rlim_t new_mem_lim = (rlim_t)mem_lim * 1024*1024;
+            rlim_t new_mem_lim = (rlim_t)mem_lim * 1024*1024 + S.arenaReserve();
             rlimit rl;
             getrlimit(RLIMIT_AS, &rl);
             if (rl.rlim_max == RLIM_INFINITY || new_mem_lim < rl.rlim_max){
@@ -195,36 +240,27 @@ int main(int argc, char** argv)
         if (argc == 1)
             printf("Reading from standard input... Use '--help' for help.\n");
 
-//        gzFile in = (argc == 1) ? gzdopen(0, "rb") : gzopen(argv[1], "rb");
-//        gzFile in1 = (argc == 1) ? gzdopen(0, "rb") : gzopen(argv[1], "rb");
-        gzFile in [num_instances];
-        for(int i = 0 ; i < num_instances ; i++) in[i] = (argc == 1) ? gzdopen(0, "rb") : gzopen(argv[1], "rb");
-
+        gzFile in = (argc == 1) ? gzdopen(0, "rb") : gzopen(argv[1], "rb");
         if (in == NULL)
             printf("ERROR! Could not open file: %s\n", argc == 1 ? "<stdin>" : argv[1]), exit(1);
 
-        if (solvers[0].verbosity > 0){
+        if (verb > 0){
             printf("============================[ Problem Statistics ]=============================\n");
             printf("|                                                                             |\n"); }
 
-//        parse_DIMACS(in, S0);
-//        parse_DIMACS(in1, S1);
-//        gzclose(in);
-//        gzclose(in1);
-        for(int i = 0 ; i < num_instances ; i++){
-            parse_DIMACS(in[i], solvers[i]);
-            gzclose(in[i]);
-        }
+        // The formula is parsed once and copied into every instance:
+        parse_DIMACS(in, S);
+        gzclose(in);
 
         FILE* res = (argc >= 3) ? fopen(argv[2], "wb") : NULL;
         std::string opFileName = "./"+problemName+"/"+"outPut.txt";  //added by @lavleshm
         FILE* opFile = fopen(opFileName.c_str(), "wb"); //added by @lavleshm
-        if (solvers[0].verbosity > 0){
-            printf("|  Number of variables:  %12d                                         |\n", solvers[0].nVars());
-            printf("|  Number of clauses:    %12d                                         |\n", solvers[0].nClauses()); }
+        if (verb > 0){
+            printf("|  Number of variables:  %12d                                         |\n", S.nVars());
+            printf("|  Number of clauses:    %12d                                         |\n", S.nClauses()); }
 
         double parsed_time = cpuTime();
-        if (solvers[0].verbosity > 0)
+        if (verb > 0)
             printf("|  Parse time:           %12.2f s                                       |\n", parsed_time - initial_time);
 
         // Change to signal-handlers that will only notify the solver and allow it to terminate
@@ -232,44 +268,6 @@ int main(int argc, char** argv)
         signal(SIGINT, SIGINT_interrupt);
         signal(SIGXCPU,SIGINT_interrupt);
 
-//        S0.eliminate(true); //handled up
-//        S1.eliminate(true); //handled up
-        for(SimpSolver& S :solvers) S.eliminate(true); //do not change its position
-        double simplified_time = cpuTime();
-        if (solvers[0].verbosity > 0){
-            printf("|  Simplification time:  %12.2f s                                       |\n", simplified_time - parsed_time);
-            printf("|                                                                             |\n"); }
-//        if (!S0.okay()){
-//            if (res != NULL) fprintf(res, "UNSAT\n"), fclose(res);
-//            if (S0.verbosity > 0){
-//                printf("===============================================================================\n");
-//                printf("Solved by simplification\n");
-//                printStats(S0);
-//                printf("\n"); }
-//            printf("UNSATISFIABLE\n");
-//            exit(20);
-//        }
-        for(SimpSolver& S : solvers){
-            if (!S.okay()){
-                if (res != NULL) fprintf(res, "UNSAT\n"), fclose(res);
-                if (S.verbosity > 0){
-                    printf("===============================================================================\n");
-                    printf("Solved by simplification\n");
-                    printStats(S);
-                    printf("\n"); }
-                printf("UNSATISFIABLE\n");
-                exit(20);
-            }
-        }
-        if (dimacs){
-            if (solvers[0].verbosity > 0)
-                printf("==============================[ Writing DIMACS ]===============================\n");
-            solvers[0].toDimacs((const char*)dimacs);
-            if (solvers[0].verbosity > 0)
-                printStats(solvers[0]);
-//                printStats(S1);
-            exit(0);
-        }
         vec<Lit> dummy;
         if (assumptions) {
             const char* file_name = assumptions;
@@ -284,70 +282,102 @@ int main(int argc, char** argv)
             }
             fclose(assertion_file);
         }
-        for( int i = 0; i < dummy.size(); i++) {
-            printf("%s%d\n", sign(dummy[i]) ? "-" : "", var(dummy[i]));
+        // Assumed variables must survive preprocessing:
+        for (int i = 0; i < dummy.size(); i++)
+            S.setFrozen(var(dummy[i]), true);
+
+        S.eliminate(true); //do not change its position
+        double simplified_time = cpuTime();
+        if (verb > 0){
+            printf("|  Simplification time:  %12.2f s                                       |\n", simplified_time - parsed_time);
+            printf("|                                                                             |\n"); }
+
+        if (!S.okay()){
+            if (res != NULL) fprintf(res, "UNSAT\n"), fclose(res);
+            if (verb > 0){
+                printf("===============================================================================\n");
+                printf("Solved by simplification\n");
+                printStats(S.instance(0));
+                printf("\n"); }
+            printf("UNSATISFIABLE\n");
+            exit(20);
         }
-        std::vector<boost::coroutines2::coroutine<void>::push_type> sinks;
-        for(int i = 0 ; i < num_instances ; i++){
-            using boost::placeholders::_1; //we may need to take it out of the loop
-            sinks.emplace_back(boost::bind(&SimpSolver::solveLimited, &solvers[i],_1));
+        if (dimacs){
+            if (verb > 0)
+                printf("==============================[ Writing DIMACS ]===============================\n");
+            S.instance(0).toDimacs((const char*)dimacs);
+            if (verb > 0)
+                printStats(S.instance(0));
+            exit(0);
         }
-//        using boost::placeholders::_1;
-//        boost::coroutines2::coroutine<void>::push_type solver{boost::bind(&SimpSolver::solveLimited, &S0,_1)};
-//        boost::coroutines2::coroutine<void>::push_type solver1{boost::bind(&SimpSolver::solveLimited, &S1, _1)};
-
-//        lbool ret = S0.solveLimited(dummy);
-//        lbool ret1 =S1.solveLimited(dummy);
-        lbool ret;
-        bool flag = true; // f1=true, f2=true;
-        bool isRunning[sinks.size()];
-        for (int j = 0; j < sinks.size(); ++j) {
-            isRunning[j] = true;
+        for( int i = 0; i < dummy.size(); i++) {
+            printf("%s%d\n", sign(dummy[i]) ? "-" : "", var(dummy[i]));
         }
-        while(flag){
-            flag = false;
-
-            for (int i = 0; i < sinks.size(); ++i) {
-                if(isRunning[i] && sinks[i]()){
-                    flag = true;
-                    if(solvers[i].readyToShare()){
-//                        S0.shareTo(S1);
-                        for (int j = 0; j < num_instances; j++){
-                            if(j != i) solvers[i].shareTo(solvers[j]);
-                        }
-                        solvers[i].sharedClauseOut.clear(); //must be called only if clause has been shared with all others
-                    }
-//                std::cout << "[main]: ....... " << std::endl; //flush here
-                }else if(isRunning[i]) {
-                    isRunning[i] = false;
-                    ret = solvers[i].ret_solveLimited_val;
-                    printf("%s ",/*argv[1]*/problemName.c_str());
-                    printStats(solvers[i]);
-                    printf("[Rank]: %d [Iterations]: %lld [Conflicts]: %ld ",solvers[i].Mpi_rank, solvers[i].iterations, solvers[i].conflicts);
-                    printf(ret == l_True ? "SATISFIABLE\n" : ret == l_False ? "UNSATISFIABLE\n" : "INDETERMINATE\n");
-
-                    //Saving to file
-                    fprintf(opFile, "%s ",/*argv[1]*/problemName.c_str());
-                    fprintf(opFile, "CPU time: %g s ", cpuTime());
-                    fprintf(opFile, "[Rank]: %d [Iterations]: %lld [Conflicts]: %ld ",solvers[i].Mpi_rank, solvers[i].iterations, solvers[i].conflicts);
-                    fprintf(opFile, ret == l_True ? "SATISFIABLE\n" : ret == l_False ? "UNSATISFIABLE\n" : "INDETERMINATE\n");
-                }
-            }
 
-        }
+        // Report every instance as it finishes:
+        S.setFinishCallback([&](int i){
+            SimpSolver& s = S.instance(i);
+            lbool       r = S.result(i);
+            printf("%s ",/*argv[1]*/problemName.c_str());
+            printStats(s);
+            printf("[Rank]: %d [Iterations]: %lld [Conflicts]: %ld ",s.Mpi_rank, s.iterations, s.conflicts);
+            if (s.walk)
+                printf("[Walk flips/restarts/best unsat]: %" PRIu64 "/%" PRIu64 "/%d ",
+                       s.localSearch().flips, s.localSearch().restarts, s.localSearch().bestUnsat());
+            else
+                printf("[Decisions%s]: %" PRIu64 " ", s.vmtf ? " (VMTF)" : "", s.decisions);
+            if (s.phase_imports > 0)
+                printf("[Phase imports]: %" PRIu64 " ", s.phase_imports);
+            if (s.rephases > 0)
+                printf("[Rephases]: %" PRIu64 " ", s.rephases);
+            printf("[Implied bin/long]: %" PRIu64 "/%" PRIu64 " ", s.bin_implied, s.long_implied);
+            printf("[Tiers core/tier2/local]: %d/%d/%d ", s.nTier(tier_Core), s.nTier(tier_Tier2), s.nTier(tier_Local));
+            if (s.restart_mode != 0)
+                printf("[Restarts/blocked]: %" PRIu64 "/%" PRIu64 " ", s.starts, s.blocked_restarts);
+            if (s.chrono >= 0)
+                printf("[Backtracks chrono/non-chrono]: %" PRIu64 "/%" PRIu64 " ", s.chrono_backtracks, s.non_chrono_backtracks);
+            if (s.reuse_trail)
+                printf("[Reused levels]: %" PRIu64 " ", s.reused_levels);
+            if (s.vivify)
+                printf("[Vivified clauses/lits]: %" PRIu64 "/%" PRIu64 " ", s.vivified_clauses, s.vivified_lits);
+            printf("[Minimized bin/shrink]: %" PRIu64 "/%" PRIu64 " ", s.bin_min_lits, s.shrunk_lits);
+            if (s.gc_collections > 0)
+                printf("[GC collections/pauses/max pause]: %" PRIu64 "/%" PRIu64 "/%.2f ms ", s.gc_collections, s.gc_pauses, s.gc_max_pause * 1000);
+            if (s.gc_forced > 0)
+                printf("[GC forced compactions]: %" PRIu64 " ", s.gc_forced);
+#if ALLOC_COUNT
+            printf("[Search allocs]: %" PRIu64 " ", s.search_allocs);
+#endif
+#if PROPAGATE_CYCLES
+            printf("[Cycles/watch]: %.1f ", s.watch_visits ? (double)s.watch_cycles / s.watch_visits : 0.0);
+#endif
+            if (stack_stats)
+                printf("[Stack]: %zu/%zu KB ", S.stackUsage(i).peak() / 1024, S.stackUsage(i).usable() / 1024);
+            printf(r == l_True ? "SATISFIABLE\n" : r == l_False ? "UNSATISFIABLE\n" : "INDETERMINATE\n");
+
+            //Saving to file
+            fprintf(opFile, "%s ",/*argv[1]*/problemName.c_str());
+            fprintf(opFile, "CPU time: %g s ", cpuTime());
+            fprintf(opFile, "[Rank]: %d [Iterations]: %lld [Conflicts]: %ld ",s.Mpi_rank, s.iterations, s.conflicts);
+            fprintf(opFile, r == l_True ? "SATISFIABLE\n" : r == l_False ? "UNSATISFIABLE\n" : "INDETERMINATE\n");
+        });
+
+        lbool ret = S.solveLimited(dummy);
         fclose(opFile);
+        if (!S.closeLogs())
+            printf("WARNING! Could not write the clause logs in: %s\n", outDir.c_str());
         if (res != NULL){
             if (ret == l_True){
                 fprintf(res, "SAT\n");
-                for (int i = 0; i < solvers[0].nVars(); i++)
-                    if (solvers[0].model[i] != l_Undef)
-                        fprintf(res, "%s%s%d", (i==0)?"":" ", (solvers[0].model[i]==l_True)?"":"-", i+1);
+                for (int i = 0; i < S.nVars(); i++)
+                    if (S.model[i] != l_Undef)
+                        fprintf(res, "%s%s%d", (i==0)?"":" ", (S.model[i]==l_True)?"":"-", i+1);
                 fprintf(res, " 0\n");
             }else if (ret == l_False) {
                 fprintf(res, "UNSAT\n");
-                for (int i = 0; i < solvers[0].conflict.size(); i++) {
+                for (int i = 0; i < S.conflict.size(); i++) {
                     // Reverse the signs to keep the same sign as the assertion file.
-                    fprintf(res, "%s%d\n", sign(solvers[0].conflict[i]) ? "" : "-", var(solvers[0].conflict[i]) + 1);
+                    fprintf(res, "%s%d\n", sign(S.conflict[i]) ? "" : "-", var(S.conflict[i]) + 1);
                 }
             } else
                 fprintf(res, "INDET\n");
@@ -0,0 +1,218 @@
+/*******************************************************************************[ParallelSolver.cc]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <vector>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "../simp/ParallelSolver.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Constructor/Destructor:
+
+
+ParallelSolver::ParallelSolver(int num_instances, const StackAllocator& sa) :
+    salloc          (sa)
+  , sharing         (true)
+  , stop_on_first   (false)
+  , progress_rounds (1000)
+  , phase_rounds    (10000)
+  , phase_exchanges (0)
+  , winner_         (-1)
+  , finished        (0)
+{
+    assert(num_instances > 0);
+    for (int i = 0; i < num_instances; i++){
+        SimpSolver* S  = new SimpSolver();
+        S->Mpi_rank    = i;
+        S->random_seed = S->Mpi_rank * S->random_seed + 273647;
+        solvers.push(S);
+        quantum.push(1);
+        stacks .push(new StackUsage());
+    }
+}
+
+
+ParallelSolver::~ParallelSolver()
+{
+    for (int i = 0; i < solvers.size(); i++){
+        delete solvers[i];
+        delete stacks[i]; }
+}
+
+
+//=================================================================================================
+// Minor methods:
+
+
+Var ParallelSolver::newVar(bool sign, bool dvar)
+{
+    Var v = var_Undef;
+    for (int i = 0; i < solvers.size(); i++)
+        v = solvers[i]->newVar(sign, dvar);
+    return v;
+}
+
+
+bool ParallelSolver::okay() const
+{
+    for (int i = 0; i < solvers.size(); i++)
+        if (!solvers[i]->okay())
+            return false;
+    return true;
+}
+
+
+bool ParallelSolver::openLogs(const std::string& dir)
+{
+    mkdir(dir.c_str(), 0777);
+
+#if CLAUSE_LOG
+    bool ok = true;
+    for (int i = 0; i < solvers.size(); i++){
+        SimpSolver& S = *solvers[i];
+        S.sFileName = dir + "/" + "shared_" + std::to_string(S.Mpi_rank) + ".bin";
+        S.lFileName = dir + "/" + "learnt_" + std::to_string(S.Mpi_rank) + ".bin";
+        ok &= S.sfile.open(S.sFileName);
+        ok &= S.lfile.open(S.lFileName);
+    }
+    return ok;
+#else
+    return false;
+#endif
+}
+
+
+bool ParallelSolver::closeLogs()
+{
+    bool ok = true;
+#if CLAUSE_LOG
+    for (int i = 0; i < solvers.size(); i++){
+        ok &= solvers[i]->sfile.close();
+        ok &= solvers[i]->lfile.close(); }
+#endif
+    return ok;
+}
+
+
+bool ParallelSolver::eliminate(bool turn_off_elim)
+{
+    bool ok = true;
+    for (int i = 0; i < solvers.size(); i++)
+        ok &= solvers[i]->eliminate(turn_off_elim);
+    return ok;
+}
+
+
+//=================================================================================================
+// Scheduling:
+
+
+void ParallelSolver::share(int from)
+{
+    vec<Lit>& out = solvers[from]->sharedClauseOut;
+    if (on_export) on_export(from, out);
+    if (sharing)
+        for (int j = 0; j < solvers.size(); j++)
+            if (j != from) solvers[from]->shareTo(*solvers[j]);
+    out.clear(); // (must be called only if clause has been shared with all others)
+}
+
+
+void ParallelSolver::finish(int i)
+{
+    running[i] = 0;
+    finished++;
+
+    lbool r = result(i);
+    if (winner_ == -1 && r != l_Undef){
+        winner_ = i;
+        solvers[i]->model   .copyTo(model);
+        solvers[i]->conflict.copyTo(conflict);
+        if (stop_on_first)
+            for (int j = 0; j < solvers.size(); j++)
+                if (running[j]) solvers[j]->interrupt();
+    }
+
+    // (these interrupts, like the ones above, are cleared again when 'solveLimited()' returns)
+    bool cdcl_left = false;
+    for (int j = 0; j < solvers.size(); j++)
+        cdcl_left |= running[j] && !solvers[j]->walk;
+    if (winner_ != -1 || !cdcl_left)
+        for (int j = 0; j < solvers.size(); j++)
+            if (running[j] && solvers[j]->walk) solvers[j]->interrupt();
+
+    if (on_finish) on_finish(i);
+}
+
+
+void ParallelSolver::exchangePhases()
+{
+    vec<int> cdcls, walks;
+    for (int i = 0; i < solvers.size(); i++)
+        if (running[i])
+            (solvers[i]->walk ? walks : cdcls).push(i);
+    if (cdcls.size() == 0 || walks.size() == 0) return;
+
+    // A walk only starts over when it is resumed, so its best assignment is still there to hand on
+    // afterwards. The walks are taken in turns for that:
+    int k = phase_exchanges++;
+    for (int i = 0; i < walks.size(); i++){
+        solvers[cdcls[(k + i) % cdcls.size()]]->exportPhases(phases);
+        solvers[walks[i]]->importPhases(phases); }
+    if (solvers[walks[k % walks.size()]]->exportPhases(phases))
+        for (int i = 0; i < cdcls.size(); i++)
+            solvers[cdcls[i]]->importPhases(phases);
+}
+
+
+lbool ParallelSolver::solveLimited(const vec<Lit>& assumps)
+{
+    model.clear();
+    conflict.clear();
+    winner_  = -1;
+    finished = 0;
+    running.clear();
+    running.growTo(solvers.size(), 1);
+
+    std::vector<Coroutine::push_type> sinks;
+    for (int i = 0; i < solvers.size(); i++)
+        sinks.emplace_back(salloc.track(*stacks[i]), [this, i, &assumps](Coroutine::pull_type& source){
+            solvers[i]->solveLimited(assumps, source); });
+
+    for (int round = 1; finished < solvers.size(); round++){
+        for (int i = 0; i < solvers.size(); i++)
+            for (int q = 0; q < quantum[i] && running[i]; q++)
+                if (sinks[i]()){
+                    if (solvers[i]->readyToShare())
+                        share(i);
+                }else
+                    finish(i);
+
+        if (phase_rounds > 0 && round % phase_rounds == 0)
+            exchangePhases();
+        if (on_progress && round % progress_rounds == 0)
+            on_progress(*this);
+    }
+
+    // Interrupts raised by 'finish()' or by the progress callback end with this call; none is left
+    // pending for the next one:
+    clearInterrupt();
+
+    return winner_ == -1 ? l_Undef : result(winner_);
+}
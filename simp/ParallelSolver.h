@@ -0,0 +1,191 @@
+/********************************************************************************[ParallelSolver.h]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Minisat_ParallelSolver_h
+#define Minisat_ParallelSolver_h
+
+#include <string>
+#include <functional>
+#include <boost/coroutine2/all.hpp>
+#include "../simp/SimpSolver.h"
+#include "../utils/StackAlloc.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// ParallelSolver -- a portfolio of 'SimpSolver' instances run as interleaved coroutines:
+//
+// The problem is specified once and copied into every instance. 'solveLimited()' then resumes the
+// instances round-robin (each one for its own quantum of search iterations per round) and passes
+// the clauses exported by an instance on to all the others.
+//
+// Instances in local search mode ('Solver::walk') take part in the same way, but exchange phases
+// instead of clauses: every 'phase_rounds' rounds, the CDCL instances take over the best assignment
+// of a walk as their saved phases, and each walk starts over from the phases of a CDCL instance.
+// A walk cannot prove unsatisfiability, so the walking instances are stopped as soon as another
+// instance has an answer, or when no CDCL instance is left running.
+//
+// Solving is incremental: 'solveLimited()' may be called repeatedly, with different assumptions and
+// with clauses added in between. Learnt and shared clauses are kept by the instances across calls.
+// Variables used in later assumptions or clauses must be frozen before they can be eliminated.
+//
+// An 'interrupt()' (from the progress callback, a signal handler, or the stopping of the other
+// instances once one has an answer) ends only the call it occurs in: 'solveLimited()' clears the
+// interrupts of all instances before it returns, so the next call starts without one pending.
+
+class ParallelSolver {
+public:
+    typedef boost::coroutines2::coroutine<void> Coroutine;
+
+    // Called with the rank of the exporting instance and the clause, before it is shared:
+    typedef std::function<void (int, const vec<Lit>&)> ExportCallback;
+    // Called every 'progress_rounds' rounds of the scheduler:
+    typedef std::function<void (ParallelSolver&)>      ProgressCallback;
+    // Called when an instance has finished (with its rank):
+    typedef std::function<void (int)>                  FinishCallback;
+
+    // Constructor/Destructor:
+    //
+    explicit ParallelSolver(int num_instances = 1, const StackAllocator& salloc = StackAllocator());
+    ~ParallelSolver();
+
+    // Problem specification (applied to every instance):
+    //
+    Var     newVar    (bool polarity = true, bool dvar = true);
+    bool    addClause (const vec<Lit>& ps);
+    bool    addClause_(      vec<Lit>& ps);                     // (for the DIMACS parser; 'ps' is not changed)
+    void    setFrozen (Var v, bool b);                          // Protect variable 'v' from elimination in every instance.
+
+    // Configuration:
+    //
+    int         nInstances ()      const;
+    SimpSolver& instance   (int i);
+    void        setVerbosity(int v);
+    void        setSharing (bool b);                            // Exchange exported clauses between the instances.
+    void        setQuantum (int i, int iterations);             // Search iterations given to instance 'i' per round.
+    void        setStopOnFirst(bool b);                         // Stop all instances as soon as one has an answer.
+    void        setPhaseExchange(int rounds);                   // Exchange phases with the walking instances every 'rounds' rounds (0=never).
+    bool        openLogs   (const std::string& dir);            // Write the binary learnt/shared clause logs into 'dir'.
+    bool        closeLogs  ();                                  // Flush and close the clause logs (FALSE on a write error).
+    void        setExportCallback  (ExportCallback cb);
+    void        setProgressCallback(ProgressCallback cb, int rounds = 1000); // Call 'cb' every 'rounds' rounds (less than 1=every round).
+    void        setFinishCallback  (FinishCallback cb);
+
+    // Solving:
+    //
+    bool    eliminate    (bool turn_off_elim = false);          // Run the simplifier of every instance.
+    lbool   solveLimited ();                                    // Run the portfolio (with resource constraints).
+    lbool   solveLimited (const vec<Lit>& assumps);             // Run the portfolio under assumptions (with resource constraints).
+    bool    okay         ()      const;                         // FALSE means some instance is in a conflicting state.
+
+    // Resource constraints (per instance):
+    //
+    void    setConfBudget(int64_t x);
+    void    setPropBudget(int64_t x);
+    void    budgetOff();
+    void    interrupt();                                        // Trigger a (potentially asynchronous) interruption of all instances.
+    void    clearInterrupt();
+
+    // Read state:
+    //
+    int     nVars      ()      const;
+    int     nClauses   ()      const;
+    int     nFinished  ()      const;
+    uint64_t clauseBytes()     const;                           // Total size of the clause arenas of all instances.
+    uint64_t arenaReserve()    const;                           // Total address space reserved for them (see '-arena-gb').
+    lbool   result     (int i) const;                           // Answer of instance 'i' in the last call to 'solveLimited()'.
+    int     winner     ()      const;                           // First instance that found the answer (-1 if none).
+    const StackUsage& stackUsage(int i) const;                  // Stack of the coroutine of instance 'i'.
+
+    // Extra results: (read-only member variable)
+    //
+    vec<lbool> model;             // If problem is satisfiable, this vector contains the model of the winner.
+    vec<Lit>   conflict;          // If problem is unsatisfiable under assumptions, the winner's final conflict.
+
+protected:
+    vec<SimpSolver*>    solvers;
+    vec<int>            quantum;
+    vec<char>           running;
+    StackAllocator      salloc;
+    vec<StackUsage*>    stacks;
+    bool                sharing;
+    bool                stop_on_first;
+    int                 progress_rounds;
+    int                 phase_rounds;
+    int                 phase_exchanges;
+    vec<char>           phases;
+    int                 winner_;
+    int                 finished;
+
+    ExportCallback      on_export;
+    ProgressCallback    on_progress;
+    FinishCallback      on_finish;
+
+    void     share        (int from);                           // Hand the exported clause of 'from' to every other instance.
+    void     finish       (int i);                              // Book-keeping when instance 'i' returns.
+    void     exchangePhases();                                  // Pass phases between the CDCL and the walking instances.
+};
+
+
+//=================================================================================================
+// Implementation of inline methods:
+
+inline int         ParallelSolver::nInstances ()      const { return solvers.size(); }
+inline SimpSolver& ParallelSolver::instance   (int i)       { return *solvers[i]; }
+inline int         ParallelSolver::nVars      ()      const { return solvers[0]->nVars(); }
+inline int         ParallelSolver::nClauses   ()      const { return solvers[0]->nClauses(); }
+inline int         ParallelSolver::nFinished  ()      const { return finished; }
+inline lbool       ParallelSolver::result     (int i) const { return solvers[i]->ret_solveLimited_val; }
+inline int         ParallelSolver::winner     ()      const { return winner_; }
+inline uint64_t    ParallelSolver::clauseBytes()      const {
+    uint64_t b = 0;
+    for (int i = 0; i < solvers.size(); i++) b += solvers[i]->clauseBytes();
+    return b; }
+inline uint64_t    ParallelSolver::arenaReserve()     const {
+    uint64_t b = 0;
+    for (int i = 0; i < solvers.size(); i++) b += solvers[i]->arenaReserve();
+    return b; }
+inline const StackUsage& ParallelSolver::stackUsage(int i) const { return *stacks[i]; }
+
+inline void ParallelSolver::setSharing    (bool b)                  { sharing = b; }
+inline void ParallelSolver::setQuantum    (int i, int iterations)   { quantum[i] = iterations; }
+inline void ParallelSolver::setStopOnFirst(bool b)                  { stop_on_first = b; }
+inline void ParallelSolver::setPhaseExchange(int rounds)            { phase_rounds = rounds; }
+inline void ParallelSolver::setExportCallback  (ExportCallback cb)  { on_export = cb; }
+inline void ParallelSolver::setProgressCallback(ProgressCallback cb, int rounds) { on_progress = cb; progress_rounds = rounds < 1 ? 1 : rounds; }
+inline void ParallelSolver::setFinishCallback  (FinishCallback cb)  { on_finish = cb; }
+
+inline bool ParallelSolver::addClause(const vec<Lit>& ps) {
+    bool ret = true;
+    for (int i = 0; i < solvers.size(); i++)
+        ret &= solvers[i]->addClause(ps);
+    return ret; }
+inline bool ParallelSolver::addClause_(vec<Lit>& ps) { return addClause(ps); }
+inline void ParallelSolver::setFrozen (Var v, bool b) { for (int i = 0; i < solvers.size(); i++) solvers[i]->setFrozen(v, b); }
+inline lbool ParallelSolver::solveLimited()           { vec<Lit> none; return solveLimited(none); }
+
+inline void ParallelSolver::setVerbosity  (int v)     { for (int i = 0; i < solvers.size(); i++) solvers[i]->verbosity = v; }
+inline void ParallelSolver::setConfBudget (int64_t x) { for (int i = 0; i < solvers.size(); i++) solvers[i]->setConfBudget(x); }
+inline void ParallelSolver::setPropBudget (int64_t x) { for (int i = 0; i < solvers.size(); i++) solvers[i]->setPropBudget(x); }
+inline void ParallelSolver::budgetOff     ()          { for (int i = 0; i < solvers.size(); i++) solvers[i]->budgetOff(); }
+inline void ParallelSolver::interrupt     ()          { for (int i = 0; i < solvers.size(); i++) solvers[i]->interrupt(); }
+inline void ParallelSolver::clearInterrupt()          { for (int i = 0; i < solvers.size(); i++) solvers[i]->clearInterrupt(); }
+
+//=================================================================================================
+}
+
+#endif
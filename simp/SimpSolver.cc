@@ -90,11 +90,19 @@ Var SimpSolver::newVar(bool sign, bool dvar) {
 
 
 
-/*lbool*/void SimpSolver::solve_(/*bool do_simp, bool turn_off_simp*/boost::coroutines2::coroutine<void>::pull_type & source)
+lbool SimpSolver::solve_(bool do_simp, bool turn_off_simp)
+{
+    boost::coroutines2::coroutine<void>::push_type sink(
+        [&](boost::coroutines2::coroutine<void>::pull_type& source){ solve_(source, do_simp, turn_off_simp); });
+    while (sink());
+    return ret_solve__val;
+}
+
+
+/*lbool*/void SimpSolver::solve_(boost::coroutines2::coroutine<void>::pull_type & source, bool do_simp, bool turn_off_simp)
 {
     vec<Var> extra_frozen;
     lbool    result = l_True;
-    bool do_simp = true;
     do_simp &= use_simplification;
 
     if (do_simp){
@@ -111,7 +119,7 @@ Var SimpSolver::newVar(bool sign, bool dvar) {
                 extra_frozen.push(v);
             } }
 
-        result = lbool(eliminate(/*turn_off_simp*/false));
+        result = lbool(eliminate(turn_off_simp));
     }
 
     if (result == l_True)
@@ -132,7 +140,7 @@ Var SimpSolver::newVar(bool sign, bool dvar) {
         for (int i = 0; i < extra_frozen.size(); i++)
             setFrozen(extra_frozen[i], false);
 
-//    return result;
+    ret_solve__val = result;
 }
 
 
@@ -481,7 +489,10 @@ bool SimpSolver::eliminateVar(Var v)
     // Split the occurrences into positive and negative:
     //
     const vec<CRef>& cls = occurs.lookup(v);
-    vec<CRef>        pos, neg;
+    vec<CRef>&       pos = elim_pos;
+    vec<CRef>&       neg = elim_neg;
+    pos.clear();
+    neg.clear();
     for (int i = 0; i < cls.size(); i++)
         (find(ca[cls[i]], mkLit(v)) ? pos : neg).push(cls[i]);
 
@@ -528,6 +539,8 @@ bool SimpSolver::eliminateVar(Var v)
     // Free watchers lists for this variable, if possible:
     if (watches[ mkLit(v)].size() == 0) watches[ mkLit(v)].clear(true);
     if (watches[~mkLit(v)].size() == 0) watches[~mkLit(v)].clear(true);
+    if (watches_bin[ mkLit(v)].size() == 0) watches_bin[ mkLit(v)].clear(true);
+    if (watches_bin[~mkLit(v)].size() == 0) watches_bin[~mkLit(v)].clear(true);
 
     return backwardSubsumptionCheck();
 }
@@ -707,6 +720,31 @@ void SimpSolver::relocAll(ClauseAllocator& to)
 
 void SimpSolver::garbageCollect()
 {
+    if (gc_step > 0 && !use_simplification){
+        // (incremental, see 'Solver::garbageStep()')
+        if (!gc_active) cleanUpClauses();
+        Solver::garbageCollect();
+        return; }
+
+    double start = threadTime();
+    gc_collections++;
+    gc_active = false;
+    if (compact_gc || ca.mapped()){
+        uint64_t before = ca.size();
+        cleanUpClauses();
+        ca.beginCompaction();
+        relocAll(ca);
+        Solver::relocAll(ca);
+        ca.forwardCompaction();
+        relocAll(ca);
+        Solver::relocAll(ca);
+        ca.endCompaction();
+        if (verbosity >= 2)
+            printf("|  Garbage compaction:   %12" PRIu64" bytes => %12" PRIu64" bytes             |\n", 
+                   before*ClauseAllocator::Unit_Size, (uint64_t)ca.size()*ClauseAllocator::Unit_Size);
+        notePause(start);
+        return; }
+
     // Initialize the next region to a size corresponding to the estimated utilization degree. This
     // is not precise but should avoid some unnecessary reallocations for the new region:
     ClauseAllocator to(ca.size() - ca.wasted()); 
@@ -716,8 +754,9 @@ void SimpSolver::garbageCollect()
     relocAll(to);
     Solver::relocAll(to);
     if (verbosity >= 2)
-        printf("|  Garbage collection:   %12d bytes => %12d bytes             |\n", 
-               ca.size()*ClauseAllocator::Unit_Size, to.size()*ClauseAllocator::Unit_Size);
+        printf("|  Garbage collection:   %12" PRIu64" bytes => %12" PRIu64" bytes             |\n", 
+               (uint64_t)ca.size()*ClauseAllocator::Unit_Size, (uint64_t)to.size()*ClauseAllocator::Unit_Size);
     to.moveTo(ca);
+    notePause(start);
 }
 
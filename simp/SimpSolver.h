@@ -56,8 +56,10 @@ class SimpSolver : public Solver {
     // Solving:
     //
     bool    solve       (const vec<Lit>& assumps, bool do_simp = true, bool turn_off_simp = false);
-//    lbool   solveLimited( const vec<Lit>& assumps, bool do_simp = true, bool turn_off_simp = false);
-    void   solveLimited(boost::coroutines2::coroutine<void>::pull_type &); //added boost coroutine
+    lbool   solveLimited(const vec<Lit>& assumps, bool do_simp = true, bool turn_off_simp = false);
+    void    solveLimited(boost::coroutines2::coroutine<void>::pull_type &); //added boost coroutine
+    void    solveLimited(const vec<Lit>& assumps, boost::coroutines2::coroutine<void>::pull_type &,
+                         bool do_simp = true, bool turn_off_simp = false);
     bool    solve       (                     bool do_simp = true, bool turn_off_simp = false);
     bool    solve       (Lit p       ,        bool do_simp = true, bool turn_off_simp = false);       
     bool    solve       (Lit p, Lit q,        bool do_simp = true, bool turn_off_simp = false);
@@ -141,11 +143,13 @@ class SimpSolver : public Solver {
     // Temporaries:
     //
     CRef                bwdsub_tmpunit;
+    vec<CRef>           elim_pos;
+    vec<CRef>           elim_neg;
 
     // Main internal methods:
     //
-//    lbool         solve_                   (bool do_simp = true, bool turn_off_simp = false);
-    void         solve_                   (boost::coroutines2::coroutine<void>::pull_type &source);
+    lbool         solve_                   (bool do_simp = true, bool turn_off_simp = false);
+    void          solve_                   (boost::coroutines2::coroutine<void>::pull_type &source, bool do_simp = true, bool turn_off_simp = false);
     bool          asymm                    (Var v, CRef cr);
     bool          asymmVar                 (Var v);
     void          updateElimHeap           (Var v);
@@ -183,22 +187,30 @@ inline bool SimpSolver::addClause    (Lit p, Lit q)          { add_tmp.clear();
 inline bool SimpSolver::addClause    (Lit p, Lit q, Lit r)   { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); return addClause_(add_tmp); }
 inline void SimpSolver::setFrozen    (Var v, bool b) { frozen[v] = (char)b; if (use_simplification && !b) { updateElimHeap(v); } }
 
-//inline bool SimpSolver::solve        (                     bool do_simp, bool turn_off_simp)  { budgetOff(); assumptions.clear(); return solve_(do_simp, turn_off_simp) == l_True; }
-//inline bool SimpSolver::solve        (Lit p       ,        bool do_simp, bool turn_off_simp)  { budgetOff(); assumptions.clear(); assumptions.push(p); return solve_(do_simp, turn_off_simp) == l_True; }
-//inline bool SimpSolver::solve        (Lit p, Lit q,        bool do_simp, bool turn_off_simp)  { budgetOff(); assumptions.clear(); assumptions.push(p); assumptions.push(q); return solve_(do_simp, turn_off_simp) == l_True; }
-//inline bool SimpSolver::solve        (Lit p, Lit q, Lit r, bool do_simp, bool turn_off_simp)  { budgetOff(); assumptions.clear(); assumptions.push(p); assumptions.push(q); assumptions.push(r); return solve_(do_simp, turn_off_simp) == l_True; }
-//inline bool SimpSolver::solve        (const vec<Lit>& assumps, bool do_simp, bool turn_off_simp){
-//    budgetOff(); assumps.copyTo(assumptions); return solve_(do_simp, turn_off_simp) == l_True; }
+inline bool SimpSolver::solve        (                     bool do_simp, bool turn_off_simp)  { budgetOff(); assumptions.clear(); return solve_(do_simp, turn_off_simp) == l_True; }
+inline bool SimpSolver::solve        (Lit p       ,        bool do_simp, bool turn_off_simp)  { budgetOff(); assumptions.clear(); assumptions.push(p); return solve_(do_simp, turn_off_simp) == l_True; }
+inline bool SimpSolver::solve        (Lit p, Lit q,        bool do_simp, bool turn_off_simp)  { budgetOff(); assumptions.clear(); assumptions.push(p); assumptions.push(q); return solve_(do_simp, turn_off_simp) == l_True; }
+inline bool SimpSolver::solve        (Lit p, Lit q, Lit r, bool do_simp, bool turn_off_simp)  { budgetOff(); assumptions.clear(); assumptions.push(p); assumptions.push(q); assumptions.push(r); return solve_(do_simp, turn_off_simp) == l_True; }
+inline bool SimpSolver::solve        (const vec<Lit>& assumps, bool do_simp, bool turn_off_simp){
+    budgetOff(); assumps.copyTo(assumptions); return solve_(do_simp, turn_off_simp) == l_True; }
 
-//inline lbool SimpSolver::solveLimited (const vec<Lit>& assumps, bool do_simp, bool turn_off_simp){
-//    assumps.copyTo(assumptions); return solve_(do_simp, turn_off_simp); }
-//////=================================================================================================
-//}
+inline lbool SimpSolver::solveLimited (const vec<Lit>& assumps, bool do_simp, bool turn_off_simp){
+    assumps.copyTo(assumptions); return solve_(do_simp, turn_off_simp); }
 
 inline void SimpSolver::solveLimited(boost::coroutines2::coroutine<void>::pull_type &source){
+    assumptions.clear();
     solve_(source);
     ret_solveLimited_val = ret_solve__val;
 }
+
+// NOTE: learnt and shared clauses are kept between calls. Variables that are to be used in
+// assumptions or in clauses added later must be frozen (or elimination turned off) beforehand.
+inline void SimpSolver::solveLimited(const vec<Lit>& assumps, boost::coroutines2::coroutine<void>::pull_type &source,
+                                     bool do_simp, bool turn_off_simp){
+    assumps.copyTo(assumptions);
+    solve_(source, do_simp, turn_off_simp);
+    ret_solveLimited_val = ret_solve__val;
+}
 //=================================================================================================
 }
 
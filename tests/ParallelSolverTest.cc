@@ -0,0 +1,134 @@
+/*****************************************************************************[ParallelSolverTest.cc]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <zlib.h>
+
+#include "../core/Dimacs.h"
+#include "../simp/ParallelSolver.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// ParallelSolver test:
+//
+// USAGE: ParallelSolverTest <php-11-10.cnf> <php-10-10.cnf>
+//
+// Checks that an interrupted 'solveLimited()' leaves nothing behind that stops the next call. The
+// unsatisfiable pigeon hole formula is not solved within the few rounds the first call gets; under
+// the assumptions 1 and 11 (pigeons 1 and 2 both in hole 1) either formula is UNSAT at once.
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+    printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+    if (!ok) failures++;
+}
+
+static void load(ParallelSolver& S, const char* file)
+{
+    gzFile in = gzopen(file, "rb");
+    if (in == NULL)
+        printf("ERROR! Could not open file: %s\n", file), exit(1);
+    parse_DIMACS(in, S);
+    gzclose(in);
+    for (Var v = 0; v < S.nVars(); v++)
+        S.setFrozen(v, true);
+}
+
+static const char* show(lbool r) { return r == l_True ? "SAT" : r == l_False ? "UNSAT" : "INDET"; }
+
+// Interrupts the portfolio from the progress callback, then solves again without it:
+static void testInterrupted(const char* php, bool stop_on_first)
+{
+    ParallelSolver S(2);
+    S.setVerbosity(0);
+    S.setStopOnFirst(stop_on_first);
+    load(S, php);
+
+    vec<Lit> none, assumps;
+    assumps.push(mkLit(0));
+    assumps.push(mkLit(10));
+
+    int rounds = 0;
+    S.setProgressCallback([&](ParallelSolver& P){ if (++rounds == 10) P.interrupt(); }, 1);
+    lbool first = S.solveLimited(none);
+    S.setProgressCallback(ParallelSolver::ProgressCallback());
+    lbool second = S.solveLimited(assumps);
+
+    char what[128];
+    snprintf(what, sizeof(what), "interrupted call is INDET (stop on first: %d): %s", stop_on_first, show(first));
+    check(first == l_Undef, what);
+    snprintf(what, sizeof(what), "next call is UNSAT (stop on first: %d): %s", stop_on_first, show(second));
+    check(second == l_False, what);
+}
+
+// A progress callback for every 0 rounds is called every round (the instances return in the round
+// after the interrupt):
+static void testProgressRounds(const char* php)
+{
+    ParallelSolver S(2);
+    S.setVerbosity(0);
+    load(S, php);
+
+    int calls = 0;
+    S.setProgressCallback([&](ParallelSolver& P){ if (++calls == 5) P.interrupt(); }, 0);
+    lbool r = S.solveLimited();
+
+    char what[128];
+    snprintf(what, sizeof(what), "progress callback for 0 rounds is called every round: %s after %d calls", show(r), calls);
+    check(r == l_Undef && calls == 6, what);
+}
+
+// A walk is stopped when a CDCL instance has the answer; it must still find the model of the
+// satisfiable formula afterwards:
+static void testWalkStopped(const char* php)
+{
+    ParallelSolver S(2);
+    S.setVerbosity(0);
+    S.instance(1).walk = true;
+    load(S, php);
+
+    vec<Lit> none, assumps;
+    assumps.push(mkLit(0));
+    assumps.push(mkLit(10));
+
+    lbool first = S.solveLimited(assumps);
+    lbool walk  = S.instance(1).solveLimited(none);
+
+    char what[128];
+    snprintf(what, sizeof(what), "call under conflicting assumptions is UNSAT: %s", show(first));
+    check(first == l_False, what);
+    snprintf(what, sizeof(what), "stopped walk finds the model afterwards: %s", show(walk));
+    check(walk == l_True, what);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+        fprintf(stderr, "USAGE: %s <php-11-10.cnf> <php-10-10.cnf>\n", argv[0]), exit(2);
+
+    testInterrupted(argv[1], false);
+    testInterrupted(argv[1], true);
+    testWalkStopped(argv[2]);
+    testProgressRounds(argv[1]);
+
+    printf(failures == 0 ? "PASS\n" : "FAIL\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+/*************************************************************************************[ServerTest.cc]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#include <string>
+
+//=================================================================================================
+// Server test:
+//
+// USAGE: ServerTest <server binary> <php-11-10.cnf>
+//
+// Starts the server on a private socket and checks that a job stopped by its time limit, or by a
+// cancel, does not stop the next job on the same formula. The pigeon hole formula cannot be solved
+// within the limit; under the assumptions 1 and 11 (pigeons 1 and 2 both in hole 1) it is UNSAT at
+// once.
+
+static pid_t       server = -1;
+static int         fd     = -1;
+static std::string pending;
+
+static void fail(const char* what, const std::string& line = std::string())
+{
+    printf("FAIL: %s%s%s\n", what, line.empty() ? "" : ": ", line.c_str());
+    if (server != -1) kill(server, SIGTERM), waitpid(server, NULL, 0);
+    exit(1);
+}
+
+static void send(const std::string& line)
+{
+    std::string s = line + "\n";
+    if (write(fd, s.data(), s.size()) != (ssize_t)s.size()) fail("write");
+}
+
+static std::string recv()
+{
+    size_t nl;
+    while ((nl = pending.find('\n')) == std::string::npos){
+        char    buf[4096];
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n <= 0) fail("connection closed");
+        pending.append(buf, n); }
+    std::string line = pending.substr(0, nl);
+    pending.erase(0, nl + 1);
+    printf("  %s\n", line.c_str());
+    return line;
+}
+
+static bool has(const std::string& line, const char* s) { return line.find(s) != std::string::npos; }
+
+// Reads the reply lines of a job up to its result:
+static std::string result()
+{
+    for (;;){
+        std::string line = recv();
+        if (has(line, "\"event\":\"error\"")) fail("error reply", line);
+        if (has(line, "\"event\":\"result\"")) return line; }
+}
+
+static void expect(const std::string& line, const char* s) { if (!has(line, s)) fail(s, line); }
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+        fprintf(stderr, "USAGE: %s <server binary> <php-11-10.cnf>\n", argv[0]), exit(2);
+
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/maplesat_test_%d.sock", (int)getpid());
+    std::string opt = std::string("-socket=") + path;
+    if ((server = fork()) == 0){
+        execl(argv[1], argv[1], opt.c_str(), (char*)NULL);
+        _exit(127); }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    for (int tries = 0;; tries++){
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0) break;
+        close(fd);
+        if (tries == 100 || waitpid(server, NULL, WNOHANG) != 0){ server = -1; fail("server did not start"); }
+        usleep(50000); }
+
+    send(std::string("load php ") + argv[2] + " solvers=2 pre=0");
+    expect(recv(), "\"event\":\"loaded\"");
+
+    // A job that runs out of time, then one that can finish:
+    send("solve php time=0.3");
+    expect(result(), "\"reason\":\"time\"");
+    send("solve php time=10 assume 1 11 0");
+    expect(result(), "\"result\":\"UNSAT\"");
+
+    // A cancelled job, then one that can finish:
+    send("solve php");
+    std::string line = recv();
+    expect(line, "\"event\":\"accepted\"");
+    int job = atoi(line.c_str() + strlen("{\"job\":"));
+    expect(recv(), "\"event\":\"started\"");
+    usleep(300000);
+    send("cancel " + std::to_string(job));
+    expect(result(), "\"reason\":\"cancelled\"");
+    send("solve php time=10 assume 1 11 0");
+    expect(result(), "\"result\":\"UNSAT\"");
+
+    send("quit");
+    close(fd);
+    kill(server, SIGTERM);
+    waitpid(server, NULL, 0);
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,158 @@
+/************************************************************************************[ClauseLog.cc]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#include "../utils/ClauseLog.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// ClauseLog:
+
+
+ClauseLog::ClauseLog(size_t buffer_words) :
+    out      (NULL)
+  , capacity (buffer_words)
+  , pending  (false)
+  , closing  (false)
+  , failed   (false)
+  , waits    (0)
+{}
+
+
+ClauseLog::~ClauseLog() { close(); }
+
+
+bool ClauseLog::open(const std::string& file)
+{
+    close();
+    out = fopen(file.c_str(), "wb");
+    if (out == NULL) return false;
+
+    uint32_t header[2] = { log_Magic, log_Version };
+    failed = fwrite(header, sizeof(uint32_t), 2, out) != 2;
+    fill .reserve(capacity + header_words);
+    spare.reserve(capacity + header_words);
+    writer = std::thread(&ClauseLog::writerLoop, this);
+    return !failed;
+}
+
+
+bool ClauseLog::close()
+{
+    if (out == NULL) return true;
+
+    if (!fill.empty()) submit();
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        closing = true;
+    }
+    ready.notify_one();
+    writer.join();
+
+    failed |= fclose(out) != 0;
+    out     = NULL;
+    closing = false;
+    return !failed;
+}
+
+
+// Hands the filled buffer over to the writer, waiting for the previous one to be written first.
+void ClauseLog::submit()
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    if (pending){
+        waits++;
+        done.wait(lock, [this]{ return !pending; }); }
+    fill.swap(spare);
+    pending = true;
+    lock.unlock();
+    ready.notify_one();
+}
+
+
+void ClauseLog::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    for (;;){
+        ready.wait(lock, [this]{ return pending || closing; });
+        if (pending){
+            lock.unlock();
+            if (fwrite(spare.data(), sizeof(uint32_t), spare.size(), out) != spare.size())
+                failed = true;
+            spare.clear();
+            lock.lock();
+            pending = false;
+            done.notify_one();
+        }else
+            return;
+    }
+}
+
+
+//=================================================================================================
+// ClauseLogReader:
+
+
+bool ClauseLogReader::open(const char* file)
+{
+    close();
+    in = fopen(file, "rb");
+    if (in == NULL) return false;
+
+    uint32_t header[2];
+    if (fread(header, sizeof(uint32_t), 2, in) != 2 || header[0] != log_Magic || header[1] != log_Version){
+        close();
+        return false; }
+
+    // The record sizes are checked against what is left of the file, so that a corrupt one can not
+    // make 'next()' allocate more than the file holds:
+    long size;
+    if (fseek(in, 0, SEEK_END) != 0 || (size = ftell(in)) < 0 || fseek(in, 2 * sizeof(uint32_t), SEEK_SET) != 0){
+        close();
+        return false; }
+    left = (uint64_t)size / sizeof(uint32_t) - 2;
+    return true;
+}
+
+
+void ClauseLogReader::close()
+{
+    if (in != NULL) fclose(in);
+    in   = NULL;
+    left = 0;
+}
+
+
+bool ClauseLogReader::next(ClauseRecord& r)
+{
+    uint32_t w[8];
+    if (in == NULL || left < 8 || fread(w, sizeof(uint32_t), 8, in) != 8)
+        return false;
+    left -= 8;
+    if (w[0] > left)
+        return false;
+    left -= w[0];
+
+    r.flags = w[1];
+    r.born  = w[2] | (uint64_t)w[3] << 32;
+    r.died  = w[4] | (uint64_t)w[5] << 32;
+    r.uses  = w[6];
+    r.lbd   = w[7];
+    r.lits.clear();
+    r.lits.growTo(w[0]);
+    return w[0] == 0 || fread((uint32_t*)&r.lits[0], sizeof(uint32_t), w[0], in) == w[0];
+}
@@ -0,0 +1,137 @@
+/*************************************************************************************[ClauseLog.h]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Minisat_ClauseLog_h
+#define Minisat_ClauseLog_h
+
+#include <stdio.h>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../mtl/IntTypes.h"
+#include "../mtl/Vec.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// Binary log of learnt/shared clauses:
+//
+// The file starts with the words 'log_Magic' and 'log_Version', followed by one record per clause.
+// All fields are 32-bit words in the byte order of the machine that wrote the log:
+//
+//     size, flags, born (lo, hi), died (lo, hi), uses, lbd, lit[0] .. lit[size-1]
+//
+// 'born' and 'died' are conflict counts of the writing instance; literals are stored as 'toInt()'.
+// Records are appended to a buffer owned by the solver; full buffers are handed to a background
+// thread that writes them out. There are two buffers, so the solver only waits for the writer if
+// it fills a second buffer before the first one is on disk.
+
+enum { log_Magic = 0x4c43534d, log_Version = 1 };   // ("MSCL")
+
+enum { log_Alive = 1 };         // The clause was still in the database when it was logged.
+
+class ClauseLog {
+    enum { header_words = 8 };
+
+    FILE*                   out;
+    size_t                  capacity;       // Words per buffer before it is handed to the writer.
+    std::vector<uint32_t>   fill;           // Owned by the solver.
+    std::vector<uint32_t>   spare;          // Owned by the writer while 'pending' is set.
+    bool                    pending;
+    bool                    closing;
+    bool                    failed;
+    uint64_t                waits;
+    std::mutex              mtx;
+    std::condition_variable ready;          // 'pending' or 'closing' was set.
+    std::condition_variable done;           // 'pending' was cleared.
+    std::thread             writer;
+
+    void submit     ();
+    void writerLoop ();
+
+public:
+    explicit ClauseLog(size_t buffer_words = 1 << 18);
+    ~ClauseLog();
+
+    bool     open   (const std::string& file);
+    bool     close  ();                     // FALSE if some record could not be written.
+    bool     isOpen () const { return out != NULL; }
+    uint64_t nWaits () const { return waits; }  // Number of times the solver had to wait for the writer.
+
+    template<class C>
+    void     write  (const C& c, uint64_t born, uint64_t died, uint32_t uses, uint32_t lbd, uint32_t flags = 0);
+};
+
+
+// Reads back the records of a binary clause log:
+struct ClauseRecord {
+    vec<int>    lits;
+    uint32_t    flags;
+    uint64_t    born;
+    uint64_t    died;
+    uint32_t    uses;
+    uint32_t    lbd;
+
+    uint64_t lifetime () const { return died - born; }
+    bool     alive    () const { return flags & log_Alive; }
+};
+
+class ClauseLogReader {
+    FILE*    in;
+    uint64_t left;                          // Words of the file not read yet.
+public:
+    ClauseLogReader() : in(NULL), left(0) {}
+    ~ClauseLogReader() { close(); }
+
+    bool open (const char* file);           // FALSE if the file can not be read or is not a clause log.
+    void close();
+    bool next (ClauseRecord& r);            // FALSE at the end of the log (or on a truncated record).
+};
+
+
+//=================================================================================================
+// Implementation of template methods:
+
+template<class C>
+inline void ClauseLog::write(const C& c, uint64_t born, uint64_t died, uint32_t uses, uint32_t lbd, uint32_t flags)
+{
+    size_t n = fill.size();
+    if (n > 0 && n + header_words + c.size() > fill.capacity()){
+        // (hand the buffer over rather than let it grow)
+        submit();
+        n = 0; }
+    fill.resize(n + header_words + c.size());
+    uint32_t* w = &fill[n];
+    w[0] = c.size();
+    w[1] = flags;
+    w[2] = (uint32_t)born; w[3] = (uint32_t)(born >> 32);
+    w[4] = (uint32_t)died; w[5] = (uint32_t)(died >> 32);
+    w[6] = uses;
+    w[7] = lbd;
+    for (int i = 0; i < c.size(); i++)
+        w[header_words + i] = (uint32_t)toInt(c[i]);
+    if (fill.size() >= capacity)
+        submit();
+}
+
+//=================================================================================================
+}
+
+#endif
@@ -21,6 +21,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef Minisat_ParseUtils_h
 #define Minisat_ParseUtils_h
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
 
@@ -87,9 +88,10 @@ static int parseInt(B& in) {
     if      (*in == '-') neg = true, ++in;
     else if (*in == '+') ++in;
     if (*in < '0' || *in > '9') fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", *in), exit(3);
-    while (*in >= '0' && *in <= '9')
+    while (*in >= '0' && *in <= '9'){
+        if (val > (INT32_MAX - (*in - '0')) / 10) fprintf(stderr, "PARSE ERROR! Integer out of range\n"), exit(3);
         val = val*10 + (*in - '0'),
-        ++in;
+        ++in; }
     return neg ? -val : val; }
 
 
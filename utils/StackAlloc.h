@@ -0,0 +1,137 @@
+/************************************************************************************[StackAlloc.h]
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT
+NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT
+OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+**************************************************************************************************/
+
+#ifndef Minisat_StackAlloc_h
+#define Minisat_StackAlloc_h
+
+#include <string.h>
+#include <boost/context/stack_context.hpp>
+#include <boost/context/stack_traits.hpp>
+#include <boost/context/fixedsize_stack.hpp>
+#include <boost/context/protected_fixedsize_stack.hpp>
+#include <boost/context/pooled_fixedsize_stack.hpp>
+#if defined(BOOST_USE_SEGMENTED_STACKS)
+#include <boost/context/segmented_stack.hpp>
+#endif
+
+namespace Minisat {
+
+//=================================================================================================
+// Stack allocation for the coroutines running the solver instances:
+//
+// NOTE: the allocator is copied into every coroutine it creates. Copies of a pooled allocator share
+// the same pool, so one allocator should be configured and then handed out with 'track()'.
+
+enum StackKind { stack_Fixed, stack_Protected, stack_Pooled, stack_Segmented };
+
+static const unsigned char stack_paint = 0xA5;
+
+// Stack given to one coroutine. If 'painted' is set, the usable part of the stack was filled with
+// 'stack_paint' when it was allocated, so the high-water mark can be read back with 'peak()'.
+struct StackUsage {
+    char*       sp;       // Top of the stack (stacks grow downwards).
+    size_t      size;     // Total size of the stack, including the guard page (if any).
+    size_t      guard;    // Number of inaccessible bytes at the bottom of the stack.
+    bool        painted;
+    size_t      released; // High-water mark measured when the stack was given back.
+
+    StackUsage() : sp(NULL), size(0), guard(0), painted(false), released(0) {}
+
+    size_t usable() const { return size - guard; }
+
+    // Number of bytes of the stack that have ever been written (0 if unknown):
+    size_t peak() const {
+        if (!painted)   return 0;
+        if (sp == NULL) return released;
+        const unsigned char* p   = (const unsigned char*)(sp - size + guard);
+        const unsigned char* end = (const unsigned char*)sp;
+        while (p < end && *p == stack_paint) p++;
+        return end - p; }
+};
+
+
+class StackAllocator {
+    StackKind   kind;
+    size_t      stack_size;
+    bool        paint;
+    StackUsage* usage;
+    boost::context::pooled_fixedsize_stack pool;
+
+    void record(const boost::context::stack_context& sctx, size_t guard) {
+        if (paint && kind != stack_Segmented)
+            memset((char*)sctx.sp - sctx.size + guard, stack_paint, sctx.size - guard);
+        if (usage == NULL) return;
+        usage->sp      = (char*)sctx.sp;
+        usage->size    = sctx.size;
+        usage->guard   = guard;
+        usage->painted = paint && kind != stack_Segmented;
+        usage->released = 0; }
+
+ public:
+    typedef boost::context::stack_traits traits_type;
+
+    StackAllocator(StackKind k = stack_Fixed, size_t sz = traits_type::default_size(), bool p = false)
+        : kind(k), stack_size(sz), paint(p), usage(NULL), pool(sz) {}
+
+    // Returns a copy of this allocator that records the stack it hands out in 'u':
+    StackAllocator track(StackUsage& u) const { StackAllocator a(*this); a.usage = &u; return a; }
+
+    size_t size() const { return stack_size; }
+
+    boost::context::stack_context allocate() {
+        boost::context::stack_context sctx;
+        switch (kind){
+        case stack_Protected: sctx = boost::context::protected_fixedsize_stack(stack_size).allocate();
+                              record(sctx, traits_type::page_size()); break;
+        case stack_Pooled:    sctx = pool.allocate(); record(sctx, 0); break;
+#if defined(BOOST_USE_SEGMENTED_STACKS)
+        case stack_Segmented: sctx = boost::context::segmented_stack(stack_size).allocate(); record(sctx, 0); break;
+#endif
+        default:              sctx = boost::context::fixedsize_stack(stack_size).allocate(); record(sctx, 0); break;
+        }
+        return sctx; }
+
+    void deallocate(boost::context::stack_context& sctx) {
+        if (usage != NULL && usage->sp == (char*)sctx.sp){
+            usage->released = usage->peak();
+            usage->sp       = NULL; }
+        switch (kind){
+        case stack_Protected: boost::context::protected_fixedsize_stack(stack_size).deallocate(sctx); break;
+        case stack_Pooled:    pool.deallocate(sctx); break;
+#if defined(BOOST_USE_SEGMENTED_STACKS)
+        case stack_Segmented: boost::context::segmented_stack(stack_size).deallocate(sctx); break;
+#endif
+        default:              boost::context::fixedsize_stack(stack_size).deallocate(sctx); break;
+        } }
+
+    // Parses one of "fixed", "protected", "pooled" or "segmented". Segmented stacks are only
+    // available if Boost was built with them; otherwise parsing fails.
+    static bool parseKind(const char* str, StackKind& k) {
+        if      (strcmp(str, "fixed")     == 0) k = stack_Fixed;
+        else if (strcmp(str, "protected") == 0) k = stack_Protected;
+        else if (strcmp(str, "pooled")    == 0) k = stack_Pooled;
+#if defined(BOOST_USE_SEGMENTED_STACKS)
+        else if (strcmp(str, "segmented") == 0) k = stack_Segmented;
+#endif
+        else return false;
+        return true; }
+};
+
+//=================================================================================================
+}
+
+#endif
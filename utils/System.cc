@@ -93,3 +93,28 @@ double Minisat::memUsed(void) {
 double Minisat::memUsed() { 
     return 0; }
 #endif
+
+
+#if ALLOC_COUNT
+// Counting wrappers around the allocation functions of glibc. The counters are per thread, so that
+// the jobs of other threads do not show up in them; 'initial-exec' keeps the access to them from
+// allocating itself (as '__tls_get_addr()' may):
+extern "C" void* __libc_malloc (size_t size);
+extern "C" void* __libc_calloc (size_t n, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+extern "C" void  __libc_free   (void* ptr);
+
+static thread_local uint64_t alloc_count __attribute__((tls_model("initial-exec"))) = 0;
+static thread_local uint64_t free_count  __attribute__((tls_model("initial-exec"))) = 0;
+
+extern "C" void* malloc (size_t size)           { alloc_count++; return __libc_malloc(size); }
+extern "C" void* calloc (size_t n, size_t size) { alloc_count++; return __libc_calloc(n, size); }
+extern "C" void* realloc(void* ptr, size_t size){ alloc_count++; return __libc_realloc(ptr, size); }
+extern "C" void  free   (void* ptr)             { if (ptr != NULL) free_count++; __libc_free(ptr); }
+
+uint64_t Minisat::allocCount() { return alloc_count; }
+uint64_t Minisat::freeCount () { return free_count; }
+#else
+uint64_t Minisat::allocCount() { return 0; }
+uint64_t Minisat::freeCount () { return 0; }
+#endif
@@ -27,13 +27,22 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 
 #include "../mtl/IntTypes.h"
 
+// Count the calls of 'malloc()', 'calloc()' and 'realloc()', and of 'free()', per thread, e.g. to check
+// that the search loop does not allocate temporaries (glibc only):
+#ifndef ALLOC_COUNT
+    #define ALLOC_COUNT false
+#endif
+
 //-------------------------------------------------------------------------------------------------
 
 namespace Minisat {
 
 static inline double cpuTime(void); // CPU-time in seconds.
+static inline double threadTime(void);// CPU-time of the calling thread in seconds (precise enough for short intervals).
 extern double memUsed();            // Memory in mega bytes (returns 0 for unsupported architectures).
 extern double memUsedPeak();        // Peak-memory in mega bytes (returns 0 for unsupported architectures).
+extern uint64_t allocCount();       // Allocations of the calling thread so far (returns 0 unless built with ALLOC_COUNT).
+extern uint64_t freeCount();        // Deallocations of the calling thread so far (ditto).
 
 }
 
@@ -44,8 +53,10 @@ extern double memUsedPeak();        // Peak-memory in mega bytes (returns 0 for
 #include <time.h>
 
 static inline double Minisat::cpuTime(void) { return (double)clock() / CLOCKS_PER_SEC; }
+static inline double Minisat::threadTime(void) { return cpuTime(); }
 
 #else
+#include <time.h>
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <unistd.h>
@@ -55,6 +66,11 @@ static inline double Minisat::cpuTime(void) {
     getrusage(RUSAGE_SELF, &ru);
     return (double)ru.ru_utime.tv_sec + (double)ru.ru_utime.tv_usec / 1000000; }
 
+static inline double Minisat::threadTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000; }
+
 #endif
 
 #endif